@@ -0,0 +1,70 @@
+#include "ConfigGenerators.h"
+#include "KeyNames.h"
+#include <fstream>
+#include <vector>
+
+std::string generateCvarSchema(size_t count) {
+    std::string json = "{\n";
+    for (size_t i = 0; i < count; ++i) {
+        json += "  \"bench_cvar_" + std::to_string(i) + "\": ";
+        switch (i % 4) {
+        case 0: json += "{\"type\": \"bool\", \"default\": false, \"min\": false, \"max\": false}"; break;
+        case 1: json += "{\"type\": \"int\", \"default\": 100, \"min\": 0, \"max\": 100000}"; break;
+        case 2: json += "{\"type\": \"float\", \"default\": 1.0, \"min\": 0.0, \"max\": 1000.0}"; break;
+        case 3: json += "{\"type\": \"color\", \"default\": \"#336699FF\"}"; break;
+        }
+        json += i + 1 < count ? ",\n" : "\n";
+    }
+    json += "}\n";
+    return json;
+}
+
+std::string generateCvarsConfig(size_t count) {
+    std::string cfg;
+    cfg.reserve(count * 32);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "bench_cvar_" + std::to_string(i);
+        cfg += name;
+        cfg.append(name.size() < 20 ? 20 - name.size() : 1, ' ');
+        switch (i % 4) {
+        case 0: cfg += (i / 4) % 2 ? "1" : "0"; break;
+        case 1: cfg += std::to_string(i % 100000); break;
+        case 2: cfg += std::to_string(i % 1000) + ".250"; break;
+        case 3: cfg += "FF8800FF"; break;
+        }
+        cfg += '\n';
+    }
+    return cfg;
+}
+
+std::string generateControlsConfig(size_t count) {
+    // Every valid chord once, then around again
+    std::vector<std::string> keys;
+    for (int scancode = 1; scancode < KEYSTR_MAX; ++scancode) {
+        if (!keyName(scancode).empty()) {
+            keys.emplace_back(keyName(scancode));
+        }
+    }
+    static const char* const prefixes[] = {"+", "-", "*", "a+", "a-", "a*", "b+", "b-", "b*", "ab+", "ab-", "ab*"};
+    const size_t prefixCount = sizeof(prefixes) / sizeof(prefixes[0]);
+
+    std::string cfg;
+    cfg.reserve(count * 40);
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 100 == 0) {
+            cfg += "\n# bench section " + std::to_string(i / 100) + "\n";
+        }
+        size_t chord = i % (keys.size() * prefixCount);
+        std::string token = std::string(prefixes[chord / keys.size()]) + keys[chord % keys.size()];
+        cfg += "bind " + token;
+        cfg.append(token.size() + 5 < 20 ? 15 - token.size() : 1, ' ');
+        cfg += "\"bench_action " + std::to_string(i) + ";save\"\n";
+    }
+    return cfg;
+}
+
+bool writeGeneratedFile(const std::string& filename, const std::string& content) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), (std::streamsize)content.size());
+    return file.good();
+}
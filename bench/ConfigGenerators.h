@@ -0,0 +1,21 @@
+#ifndef CONFIGGENERATORS_H
+#define CONFIGGENERATORS_H
+
+#include <cstddef>
+#include <string>
+
+// Synthetic inputs for the benchmarks. Output is deterministic for a given count.
+
+// cvars.json with `count` cvars named bench_cvar_<i>, cycling through every cvar type
+std::string generateCvarSchema(size_t count);
+
+// cvars.cfg assigning every cvar of generateCvarSchema(count) a value within its range
+std::string generateCvarsConfig(size_t count);
+
+// controls.cfg with `count` bind lines over every chord, in sections of 100 lines
+std::string generateControlsConfig(size_t count);
+
+// Write content to filename, replacing it. Returns false on failure.
+bool writeGeneratedFile(const std::string& filename, const std::string& content);
+
+#endif // CONFIGGENERATORS_H
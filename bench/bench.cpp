@@ -0,0 +1,175 @@
+// Benchmarks for loading, saving and drawing configs of 1k to 1M entries.
+// Results are printed to stdout as JSON; progress messages of the loaders go to stderr.
+#define SDL_MAIN_HANDLED
+
+#include "ConfigGenerators.h"
+#include "CvarManager.h"
+#include "ControlsManager.h"
+#include "BindTable.h"
+#include "SchemaCache.h"
+#include "imgui.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// Timings of one benchmark at one size
+static json measure(const std::string& name, size_t entries, int iterations, const std::function<void()>& setup,
+                    const std::function<void()>& run) {
+    std::vector<double> milliseconds;
+    for (int i = 0; i < iterations; ++i) {
+        setup();
+        Clock::time_point start = Clock::now();
+        run();
+        milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(milliseconds.begin(), milliseconds.end());
+
+    double median = milliseconds[milliseconds.size() / 2];
+    std::cerr << name << " (" << entries << "): " << median << " ms" << std::endl;
+    return {
+        {"name", name},
+        {"entries", entries},
+        {"iterations", iterations},
+        {"min_ms", milliseconds.front()},
+        {"median_ms", median},
+        {"max_ms", milliseconds.back()},
+        {"ns_per_entry", median * 1e6 / (double)std::max<size_t>(entries, 1)},
+    };
+}
+
+// Draw one frame of the cvar editor without a renderer
+static void renderCvarFrame() {
+    ImGui::NewFrame();
+    ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_Always);
+    ImGui::Begin("Cvars Editor");
+    renderCvars();
+    ImGui::End();
+    ImGui::Render();
+}
+
+static std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::istringstream in(list);
+    std::string size;
+    while (std::getline(in, size, ',')) {
+        sizes.push_back(std::stoul(size));
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    int iterations = 5;
+    fs::path directory = fs::temp_directory_path() / "okesl-config-bench";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--sizes") {
+            sizes = parseSizes(argv[i + 1]);
+        } else if (option == "--iterations") {
+            iterations = std::max(1, std::atoi(argv[i + 1]));
+        } else if (option == "--dir") {
+            directory = argv[i + 1];
+        } else {
+            std::cerr << "Usage: okesl-config-bench [--sizes 1000,10000] [--iterations 5] [--dir <scratch directory>]" << std::endl;
+            return 2;
+        }
+    }
+
+    // Keep stdout for the JSON report; the loaders report progress on std::cout
+    std::ostream report(std::cout.rdbuf());
+    std::cout.rdbuf(std::clog.rdbuf());
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Failed to create " << directory << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    // A context without a renderer backend is enough to build and submit frames
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    json results = json::array();
+    for (size_t size : sizes) {
+        const std::string schemaFile = (directory / ("cvars_" + std::to_string(size) + ".json")).string();
+        const std::string cvarsFile = (directory / ("cvars_" + std::to_string(size) + ".cfg")).string();
+        const std::string controlsFile = (directory / ("controls_" + std::to_string(size) + ".cfg")).string();
+        std::string savedCvars;
+        int saveRun = 0;
+        if (!writeGeneratedFile(schemaFile, generateCvarSchema(size)) ||
+            !writeGeneratedFile(cvarsFile, generateCvarsConfig(size)) ||
+            !writeGeneratedFile(controlsFile, generateControlsConfig(size))) {
+            std::cerr << "Failed to write generated files to " << directory << std::endl;
+            return 1;
+        }
+
+        // Schema from JSON, then from the binary cache the first load writes
+        results.push_back(measure("load_schema_json", size, iterations, [&] {
+            cvars.clear();
+            fs::remove(SchemaCache::path(schemaFile), ec);
+        }, [&] { loadCvarSchema(schemaFile); }));
+        results.push_back(measure("load_schema_cached", size, iterations, [&] {
+            cvars.clear();
+        }, [&] { loadCvarSchema(schemaFile); }));
+
+        results.back()["memory_high_water_bytes"] = cvarMemoryHighWaterMark();
+
+        results.push_back(measure("load_cvars", size, iterations, [&] {
+            cvars.clear();
+        }, [&] { loadCvars(schemaFile, cvarsFile); }));
+
+        // A new file every run, so every cvar is written out. Values read from a file are
+        // saved back to that file, so start from the schema alone.
+        results.push_back(measure("save_cvars", size, iterations, [&] {
+            cvars.clear();
+            loadCvarSchema(schemaFile);
+            savedCvars = (directory / ("saved_cvars_" + std::to_string(saveRun++) + ".cfg")).string();
+        }, [&] { saveCvarsToFile(savedCvars); }));
+
+        results.push_back(measure("render_cvars_frame", size, iterations, [&] {
+            invalidateCvarView(); // Include sorting the view, as after a load
+        }, [&] { renderCvarFrame(); }));
+        results.push_back(measure("render_cvars_frame_steady", size, iterations, [] {}, [&] { renderCvarFrame(); }));
+
+        results.push_back(measure("load_controls", size, iterations, [&] {
+            bindTable.clear();
+        }, [&] { loadControls(controlsFile); }));
+        results.back()["memory_bytes"] = bindTable.memoryInUse();
+        results.back()["memory_high_water_bytes"] = bindTable.memoryHighWaterMark();
+
+        // Rebind a control and save it into the loaded file, as the editor does: the whole
+        // file is read through and written back with the one change
+        results.push_back(measure("save_controls", size, iterations, [&] {
+            setControlKey("throttle", saveRun++ % 2 == 0 ? "*f9" : "*f10");
+        }, [&] { saveControls(controlsFile); }));
+
+        cvars.clear();
+        bindTable.clear();
+        fs::remove(SchemaCache::path(schemaFile), ec); // Its schema goes with the scratch directory
+    }
+
+    ImGui::DestroyContext();
+    fs::remove_all(directory, ec);
+
+    report << json{{"benchmarks", results}}.dump(2) << std::endl;
+    std::cout.rdbuf(report.rdbuf());
+    return 0;
+}
@@ -3,7 +3,7 @@
 
 #define KEYSTR_MAX 232
 
-static const char keystr[KEYSTR_MAX][20] = {"",
+static constexpr char keystr[KEYSTR_MAX][20] = {"",
                                             "",
                                             "",
                                             "",
@@ -0,0 +1,264 @@
+#include "AsyncSaver.h"
+#include "FrameScheduler.h"
+#include "Trace.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Quiet period after the last request before a file is written
+static const std::chrono::milliseconds coalesceDelay(200);
+
+struct PendingSave {
+    std::string content;
+    Clock::time_point due;
+    SaveCallback onSaved;
+    uint64_t serial = 0;
+};
+
+// A save that was written and whose callback has not run yet
+struct FinishedSave {
+    std::string filename;
+    uint64_t serial;
+    SaveCallback onSaved;
+    std::string content;
+};
+
+// The latest save queued for a file, numbered so an older one finishing does not drop it
+struct QueuedSave {
+    std::string content;
+    uint64_t serial;
+};
+
+static std::mutex saverMutex;
+static std::condition_variable saverWakeup;
+static std::map<std::string, PendingSave> pendingSaves;
+static std::vector<FinishedSave> finishedSaves;
+static std::map<std::string, QueuedSave> queuedSaves; // Until runSaveCallbacks() has seen them written
+static uint64_t saveSerial = 0;
+static std::thread saverThread;
+static bool saverStopping = false;
+
+#ifdef _WIN32
+
+static bool writeAndSync(const std::string& filename, const std::string& content) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    DWORD written = 0;
+    bool ok = WriteFile(file, content.data(), (DWORD)content.size(), &written, nullptr) && written == content.size();
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+}
+
+static bool replaceFile(const std::string& from, const std::string& to) {
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+#else
+
+// The temporary file is new (O_EXCL), so a stale one from a crashed writer is never reused.
+// Calls interrupted by a signal are retried.
+static bool writeAndSync(const std::string& filename, const std::string& content) {
+    int fd;
+    do {
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return false;
+    }
+    const char* data = content.data();
+    size_t remaining = content.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(fd);
+            return false;
+        }
+        data += written;
+        remaining -= (size_t)written;
+    }
+    int synced;
+    do {
+        synced = fsync(fd);
+    } while (synced != 0 && errno == EINTR);
+    // close() must not be retried on EINTR: the descriptor is already released on Linux
+    return ::close(fd) == 0 && synced == 0;
+}
+
+static bool replaceFile(const std::string& from, const std::string& to) {
+    if (std::rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+
+    // Persist the rename itself by syncing the containing directory
+    size_t slash = to.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : to.substr(0, slash + 1);
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+    return true;
+}
+
+#endif
+
+// Temporary file next to filename, unique to this process and call, so the background
+// writer and a synchronous save of the same file never write into each other's file
+static std::string temporaryFilename(const std::string& filename) {
+    static std::atomic<unsigned> counter{0};
+#ifdef _WIN32
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long)getpid();
+#endif
+    return filename + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+}
+
+bool writeFileAtomically(const std::string& filename, const std::string& content) {
+    TRACE_ZONE("writeFileAtomically");
+    const std::string tempFilename = temporaryFilename(filename);
+    if (!writeAndSync(tempFilename, content) || !replaceFile(tempFilename, filename)) {
+        std::remove(tempFilename.c_str());
+        std::cerr << "Failed to write " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Stop reporting a file's queued save once its write is over, unless a newer one was queued.
+// Called with saverMutex held.
+static void forgetQueuedSave(const std::string& filename, uint64_t serial) {
+    auto queued = queuedSaves.find(filename);
+    if (queued != queuedSaves.end() && queued->second.serial == serial) {
+        queuedSaves.erase(queued);
+    }
+}
+
+static void saverLoop() {
+    std::unique_lock<std::mutex> lock(saverMutex);
+    while (true) {
+        if (pendingSaves.empty()) {
+            if (saverStopping) {
+                return;
+            }
+            saverWakeup.wait(lock);
+            continue;
+        }
+
+        // Wait for the earliest request to become due unless we are flushing on shutdown
+        auto next = pendingSaves.begin();
+        for (auto it = pendingSaves.begin(); it != pendingSaves.end(); ++it) {
+            if (it->second.due < next->second.due) {
+                next = it;
+            }
+        }
+        if (!saverStopping && Clock::now() < next->second.due) {
+            saverWakeup.wait_until(lock, next->second.due);
+            continue;
+        }
+
+        std::string filename = next->first;
+        std::string content = std::move(next->second.content);
+        SaveCallback onSaved = std::move(next->second.onSaved);
+        uint64_t serial = next->second.serial;
+        pendingSaves.erase(next);
+
+        lock.unlock();
+        bool saved = writeFileAtomically(filename, content);
+        if (saved) {
+            std::cout << "Configuration saved to " << filename << std::endl;
+        }
+        lock.lock();
+        if (saved) {
+            if (onSaved) {
+                requestRedraw();
+            }
+            finishedSaves.push_back({std::move(filename), serial, std::move(onSaved), std::move(content)});
+        } else {
+            forgetQueuedSave(filename, serial); // The file still has what the editors last saw
+        }
+    }
+}
+
+void queueSave(const std::string& filename, std::string content, SaveCallback onSaved) {
+    std::lock_guard<std::mutex> lock(saverMutex);
+    if (!saverThread.joinable()) {
+        saverStopping = false;
+        saverThread = std::thread(saverLoop);
+    }
+
+    // A newer snapshot replaces an unwritten one and restarts its quiet period
+    PendingSave& pending = pendingSaves[filename];
+    pending.content = std::move(content);
+    pending.due = Clock::now() + coalesceDelay;
+    pending.onSaved = std::move(onSaved);
+    pending.serial = ++saveSerial;
+    queuedSaves[filename] = {pending.content, pending.serial};
+    saverWakeup.notify_one();
+}
+
+bool queuedSaveContent(const std::string& filename, std::string& content) {
+    std::lock_guard<std::mutex> lock(saverMutex);
+    auto queued = queuedSaves.find(filename);
+    if (queued == queuedSaves.end()) {
+        return false;
+    }
+    content = queued->second.content;
+    return true;
+}
+
+void runSaveCallbacks() {
+    std::vector<FinishedSave> finished;
+    {
+        std::lock_guard<std::mutex> lock(saverMutex);
+        finished.swap(finishedSaves);
+    }
+    for (const FinishedSave& save : finished) {
+        if (save.onSaved) {
+            save.onSaved(save.content);
+        }
+    }
+
+    // The editors have the written text now; later saves start from it
+    std::lock_guard<std::mutex> lock(saverMutex);
+    for (const FinishedSave& save : finished) {
+        forgetQueuedSave(save.filename, save.serial);
+    }
+}
+
+void shutdownSaver() {
+    {
+        std::lock_guard<std::mutex> lock(saverMutex);
+        if (!saverThread.joinable()) {
+            return;
+        }
+        saverStopping = true;
+    }
+    saverWakeup.notify_one();
+    saverThread.join();
+}
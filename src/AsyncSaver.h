@@ -0,0 +1,32 @@
+#ifndef ASYNCSAVER_H
+#define ASYNCSAVER_H
+
+#include <functional>
+#include <string>
+
+// Replace filename with content so that readers only ever see the old or the new file:
+// the content goes to a temporary file, is flushed to disk and renamed over the target.
+bool writeFileAtomically(const std::string& filename, const std::string& content);
+
+// Called with the content a queued save wrote, once it is on disk
+using SaveCallback = std::function<void(const std::string& content)>;
+
+// Queue a snapshot of a file's content for the background writer. Requests for the same
+// file that arrive within a short window are merged and only the latest one is written;
+// only its onSaved runs, and only if the write succeeded.
+void queueSave(const std::string& filename, std::string content, SaveCallback onSaved = nullptr);
+
+// Content of the latest save queued for filename until runSaveCallbacks() has reported it
+// written: while it waits, while it is written and until its callback ran. Returns false
+// when there is none. A save that patches the file starts from this text, so replacing a
+// waiting save loses none of its edits.
+bool queuedSaveContent(const std::string& filename, std::string& content);
+
+// Run the callbacks of the saves written since the last call. Call from the main loop, so
+// the callbacks may touch the editor's state.
+void runSaveCallbacks();
+
+// Write everything still queued and stop the background writer
+void shutdownSaver();
+
+#endif // ASYNCSAVER_H
@@ -0,0 +1,271 @@
+#include "BindTable.h"
+#include <algorithm>
+
+BindTable bindTable;
+
+bool parseBindChord(std::string_view token, BindChord& chord) {
+    chord = BindChord();
+
+    // Modifier groups come first, then the trigger
+    size_t position = 0;
+    while (position < token.size() && (token[position] == 'a' || token[position] == 'b')) {
+        chord.modifiers |= token[position] == 'a' ? BindModifierA : BindModifierB;
+        ++position;
+    }
+    if (position >= token.size()) {
+        return false;
+    }
+
+    switch (token[position]) {
+    case '+': chord.trigger = BindTrigger::Press; break;
+    case '-': chord.trigger = BindTrigger::Release; break;
+    case '*': chord.trigger = BindTrigger::Hold; break;
+    default: return false;
+    }
+
+    chord.scancode = keyScancode(token.substr(position + 1));
+    return chord.scancode > 0;
+}
+
+std::string formatBindChord(const BindChord& chord) {
+    std::string token;
+    if (chord.modifiers & BindModifierA) token += 'a';
+    if (chord.modifiers & BindModifierB) token += 'b';
+    switch (chord.trigger) {
+    case BindTrigger::Press: token += '+'; break;
+    case BindTrigger::Release: token += '-'; break;
+    case BindTrigger::Hold: token += '*'; break;
+    }
+    token += keyName(chord.scancode);
+    return token;
+}
+
+size_t BindTable::keyIndex(const BindChord& chord) {
+    return (size_t)(chord.modifiers & 3) * KEYSTR_MAX + (size_t)chord.scancode;
+}
+
+size_t BindTable::slotIndex(const BindChord& chord) {
+    return (size_t)chord.trigger * keyCount + keyIndex(chord);
+}
+
+const std::pmr::string* BindTable::find(const BindChord& chord) const {
+    const std::pmr::vector<BindSource>* bound = sources(chord);
+    return bound ? &bound->back().actions : nullptr;
+}
+
+const std::pmr::vector<BindSource>* BindTable::sources(const BindChord& chord) const {
+    if (!validChord(chord)) {
+        return nullptr;
+    }
+    uint32_t entry = slots[slotIndex(chord)];
+    return entry != 0 ? &generation->entries[entry - 1].sources : nullptr;
+}
+
+// Entry of a chord, allocating one if it is unbound
+BindTable::Entry& BindTable::acquire(const BindChord& chord) {
+    std::pmr::vector<Entry>& entries = generation->entries;
+    std::pmr::vector<uint32_t>& freeEntries = generation->freeEntries;
+    uint32_t& slot = slots[slotIndex(chord)];
+    if (slot == 0) {
+        // Reuse a freed entry before growing
+        if (!freeEntries.empty()) {
+            slot = freeEntries.back() + 1;
+            freeEntries.pop_back();
+        } else {
+            entries.emplace_back();
+            slot = (uint32_t)entries.size();
+        }
+        ++boundCount;
+    }
+
+    Entry& entry = entries[slot - 1];
+    entry.chord = chord;
+    entry.bound = true;
+    return entry;
+}
+
+// Free the entry of a slot
+void BindTable::release(size_t slot) {
+    uint32_t entry = slots[slot];
+    if (entry == 0) {
+        return;
+    }
+    Entry& freed = generation->entries[entry - 1];
+    for (const BindSource& source : freed.sources) {
+        countSource(freed.chord, source.actions, false);
+    }
+    freed.bound = false;
+    freed.sources.clear();
+    generation->freeEntries.push_back(entry - 1);
+    slots[slot] = 0;
+    --boundCount;
+}
+
+// Count a source added to or removed from a chord in its distinct actions, and update the
+// chord's conflict bit
+void BindTable::countSource(const BindChord& chord, std::string_view actions, bool added) {
+    size_t slot = slotIndex(chord);
+    std::vector<ChordActions>& counted = slotActions[slot];
+    auto same = std::find_if(counted.begin(), counted.end(), [&](const ChordActions& entry) {
+        return entry.actions == actions;
+    });
+    if (added) {
+        if (same != counted.end()) {
+            ++same->sourceCount;
+        } else {
+            counted.push_back({std::string(actions), 1});
+        }
+    } else if (same != counted.end() && --same->sourceCount == 0) {
+        counted.erase(same);
+    }
+    conflicts.set(slot, counted.size() > 1);
+}
+
+void BindTable::bind(const BindChord& chord, std::string_view actions, std::string_view file, size_t line) {
+    if (!validChord(chord)) {
+        return;
+    }
+
+    Entry& entry = acquire(chord);
+    if (line != 0 && !entry.sources.empty() && entry.sources.back().line == line &&
+        std::string_view(entry.sources.back().file) == file) {
+        countSource(chord, entry.sources.back().actions, false);
+        entry.sources.back().actions.assign(actions.data(), actions.size());
+    } else {
+        BindSource& source = entry.sources.emplace_back();
+        source.file = file;
+        source.line = line;
+        source.actions = actions;
+    }
+    countSource(chord, actions, true);
+}
+
+void BindTable::move(const BindChord& from, const BindChord& to, std::string_view actions) {
+    BindSource moved(generation->entries.get_allocator());
+    moved.actions = actions;
+    if (validChord(from) && slots[slotIndex(from)] != 0) {
+        size_t fromSlot = slotIndex(from);
+        std::pmr::vector<BindSource>& bound = generation->entries[slots[fromSlot] - 1].sources;
+        for (size_t i = bound.size(); i-- > 0;) {
+            if (bound[i].actions == actions) {
+                moved = std::move(bound[i]);
+                bound.erase(bound.begin() + i);
+                countSource(from, actions, false);
+                break;
+            }
+        }
+        if (bound.empty()) {
+            release(fromSlot);
+        }
+    }
+
+    if (validChord(to)) {
+        acquire(to).sources.push_back(std::move(moved));
+        countSource(to, actions, true);
+    }
+    compactIfWasteful();
+}
+
+void BindTable::rebind(const BindChord& chord, std::string_view from, std::string_view to) {
+    if (!validChord(chord)) {
+        return;
+    }
+
+    Entry& entry = acquire(chord);
+    auto same = std::find_if(entry.sources.rbegin(), entry.sources.rend(), [&](const BindSource& source) {
+        return std::string_view(source.actions) == from;
+    });
+    if (same != entry.sources.rend()) {
+        countSource(chord, from, false);
+        same->actions.assign(to.data(), to.size());
+    } else {
+        entry.sources.emplace_back().actions = to;
+    }
+    countSource(chord, to, true);
+    compactIfWasteful();
+}
+
+void BindTable::unbind(const BindChord& chord) {
+    if (validChord(chord)) {
+        release(slotIndex(chord));
+        compactIfWasteful();
+    }
+}
+
+void BindTable::unbindFile(std::string_view file) {
+    for (Entry& entry : generation->entries) {
+        if (!entry.bound) {
+            continue;
+        }
+        auto removed = std::remove_if(entry.sources.begin(), entry.sources.end(), [&](const BindSource& source) {
+            if (std::string_view(source.file) != file) {
+                return false;
+            }
+            countSource(entry.chord, source.actions, false);
+            return true;
+        });
+        if (removed == entry.sources.end()) {
+            continue;
+        }
+        entry.sources.erase(removed, entry.sources.end());
+        if (entry.sources.empty()) {
+            release(slotIndex(entry.chord));
+        }
+    }
+    compactIfWasteful();
+}
+
+void BindTable::bindInOrder(const BindChord& chord, std::string_view actions, std::string_view file, size_t line,
+                            const std::function<bool(std::string_view)>& runsLater) {
+    if (!validChord(chord)) {
+        return;
+    }
+
+    Entry& entry = acquire(chord);
+    auto later = std::find_if(entry.sources.begin(), entry.sources.end(), [&](const BindSource& source) {
+        return runsLater(source.file);
+    });
+    BindSource& source = *entry.sources.emplace(later);
+    source.file = file;
+    source.line = line;
+    source.actions = actions;
+    countSource(chord, actions, true);
+}
+
+bool BindTable::hasConflict(const BindChord& chord) const {
+    return validChord(chord) && conflicts.test(slotIndex(chord));
+}
+
+void BindTable::clear() {
+    slots.fill(0);
+    for (std::vector<ChordActions>& counted : slotActions) {
+        counted.clear();
+    }
+    conflicts.reset();
+    boundCount = 0;
+
+    // The old generation's containers and arena go in one step
+    generation = std::make_unique<Generation>(&heap);
+    compactedBytes = heap.bytesInUse();
+}
+
+void BindTable::compact() {
+    auto fresh = std::make_unique<Generation>(&heap);
+    fresh->entries.reserve(boundCount);
+    for (const Entry& entry : generation->entries) {
+        if (entry.bound) {
+            fresh->entries.push_back(entry); // Copied into the new arena
+            slots[slotIndex(entry.chord)] = (uint32_t)fresh->entries.size();
+        }
+    }
+    generation = std::move(fresh);
+    compactedBytes = heap.bytesInUse();
+}
+
+// Compact once the arena has grown well past what was live at the last compaction. Not
+// called while binding, so a load fills the arena without copying.
+void BindTable::compactIfWasteful() {
+    if (heap.bytesInUse() > 2 * compactedBytes + 64 * 1024) {
+        compact();
+    }
+}
@@ -0,0 +1,189 @@
+#ifndef BINDTABLE_H
+#define BINDTABLE_H
+
+#include "KeyNames.h"
+#include "ConfigArena.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Modifier groups registered with "mod a ..." and "mod b ..."
+enum BindModifier : uint8_t {
+    BindModifierNone = 0,
+    BindModifierA = 1,
+    BindModifierB = 2
+};
+
+// When a bind fires
+enum class BindTrigger : uint8_t {
+    Press,   // "+"
+    Release, // "-"
+    Hold     // "*"
+};
+
+// Key combination of a bind line, e.g. "ab*f5"
+struct BindChord {
+    uint8_t modifiers = BindModifierNone; // Mask of BindModifier
+    BindTrigger trigger = BindTrigger::Press;
+    int scancode = 0;
+};
+
+// Parse the key token of a bind line ("[a][b]{+|-|*}<key>")
+bool parseBindChord(std::string_view token, BindChord& chord);
+
+// Format a chord the way it is written in a bind line
+std::string formatBindChord(const BindChord& chord);
+
+// Where a chord was bound, and to what. Allocator-aware, so its strings live in the arena
+// of the bind table holding it.
+struct BindSource {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    explicit BindSource(const allocator_type& alloc = {}) : file(alloc), actions(alloc) {}
+    BindSource(const BindSource& other, const allocator_type& alloc)
+        : file(other.file, alloc), line(other.line), actions(other.actions, alloc) {}
+    BindSource(BindSource&& other, const allocator_type& alloc)
+        : file(std::move(other.file), alloc), line(other.line), actions(std::move(other.actions), alloc) {}
+    BindSource(const BindSource&) = default;
+    BindSource(BindSource&&) = default;
+    BindSource& operator=(const BindSource&) = default;
+    BindSource& operator=(BindSource&&) = default;
+
+    std::pmr::string file;    // Config file of the bind line, or empty for a bind made in the editor
+    size_t line = 0;          // 1-based line number in that file
+    std::pmr::string actions; // Canonical actions string
+};
+
+// Every bind line, indexed directly by (modifiers, trigger, scancode). A chord bound by
+// several lines keeps all of them as sources; the last one is what the game uses.
+//
+// The sources are allocated from a monotonic arena per load generation: loading a large
+// bind set takes a few big blocks instead of thousands of small allocations, and clear()
+// drops the arena with everything in it in one step. Changes after the load (reloads,
+// editor moves) leave dead memory in the arena, so once it holds about twice what was live
+// at the last compaction, the live binds are copied into a new generation. Pointers from
+// find() and sources() are only valid until the next change.
+class BindTable {
+public:
+    static const size_t keyCount = 4 * KEYSTR_MAX; // Modifier masks times scancodes
+    static const size_t slotCount = 3 * keyCount;  // Times triggers
+
+    BindTable() : generation(std::make_unique<Generation>(&heap)) { slots.fill(0); }
+
+    // Actions bound to a chord, or nullptr
+    const std::pmr::string* find(const BindChord& chord) const;
+
+    // Every source of a chord in bind order, or nullptr when it is unbound
+    const std::pmr::vector<BindSource>* sources(const BindChord& chord) const;
+
+    // Add a source to a chord. A source from the same file and line as the chord's last
+    // source replaces it.
+    void bind(const BindChord& chord, std::string_view actions, std::string_view file = std::string_view(), size_t line = 0);
+
+    // Move the last source with the given actions from one chord to another, keeping its
+    // file and line. Binds from the editor when from has no such source, and only removes
+    // the source when to is not a valid chord (e.g. the key was cleared).
+    void move(const BindChord& from, const BindChord& to, std::string_view actions);
+
+    // Give the last source of a chord bound to one actions string another, keeping its
+    // file and line. Binds from the editor when the chord has no such source.
+    void rebind(const BindChord& chord, std::string_view from, std::string_view to);
+
+    void unbind(const BindChord& chord);
+
+    // Remove every source that came from a file, e.g. before binding its new lines
+    void unbindFile(std::string_view file);
+
+    // Add a source of a file at its place in exec order: before the chord's first source
+    // from a file for which runsLater(file) is true. A re-read file's binds then stay
+    // behind those of files executed after it.
+    void bindInOrder(const BindChord& chord, std::string_view actions, std::string_view file, size_t line,
+                     const std::function<bool(std::string_view)>& runsLater);
+
+    // Remove every bind and start a new load generation
+    void clear();
+
+    // Copy the live binds into a new generation and free the old arena
+    void compact();
+
+    size_t size() const { return boundCount; }
+
+    // Whether a chord is bound to different actions in more than one place. Press, release
+    // and hold binds of one key fire at different times, so they never conflict.
+    bool hasConflict(const BindChord& chord) const;
+    size_t conflictCount() const { return conflicts.count(); }
+
+    // Memory taken from the heap by the arena, now and at most
+    size_t memoryInUse() const { return heap.bytesInUse(); }
+    size_t memoryHighWaterMark() const { return heap.highWaterMark(); }
+
+    // Call fn(chord, actions) for every bound chord
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const Entry& entry : generation->entries) {
+            if (entry.bound) {
+                fn(entry.chord, entry.sources.back().actions);
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        explicit Entry(const allocator_type& alloc) : sources(alloc) {}
+        Entry(const Entry& other, const allocator_type& alloc)
+            : chord(other.chord), sources(other.sources, alloc), bound(other.bound) {}
+        Entry(Entry&& other, const allocator_type& alloc)
+            : chord(other.chord), sources(std::move(other.sources), alloc), bound(other.bound) {}
+
+        BindChord chord;
+        std::pmr::vector<BindSource> sources;
+        bool bound = false;
+    };
+
+    // The arena of one load generation and the containers allocated from it. The
+    // containers are destroyed before the arena, which then frees all of it at once.
+    struct Generation {
+        explicit Generation(std::pmr::memory_resource* upstream)
+            : arena(upstream), entries(&arena), freeEntries(&arena) {}
+
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<Entry> entries;
+        std::pmr::vector<uint32_t> freeEntries;
+    };
+
+    // One of the distinct actions strings bound to a chord
+    struct ChordActions {
+        std::string actions;
+        uint32_t sourceCount = 0;
+    };
+
+    static bool validChord(const BindChord& chord) { return chord.scancode > 0 && chord.scancode < KEYSTR_MAX; }
+    static size_t keyIndex(const BindChord& chord);
+    static size_t slotIndex(const BindChord& chord);
+    Entry& acquire(const BindChord& chord);
+    void release(size_t slot);
+    void countSource(const BindChord& chord, std::string_view actions, bool added);
+    void compactIfWasteful();
+
+    CountingResource heap; // Upstream of every generation's arena
+    std::unique_ptr<Generation> generation;
+    size_t compactedBytes = 0; // Heap use right after the last compaction or clear
+    std::array<uint32_t, slotCount> slots; // Entry index + 1, or 0 when unbound
+    std::array<std::vector<ChordActions>, slotCount> slotActions; // Per slot
+    std::bitset<slotCount> conflicts;      // Chords bound to more than one actions string
+    size_t boundCount = 0;
+};
+
+// Every bind line loaded from the config files
+extern BindTable bindTable;
+
+#endif // BINDTABLE_H
@@ -0,0 +1,108 @@
+#include "CommandTrie.h"
+#include <algorithm>
+#include <utility>
+
+void CommandTrie::build(const std::vector<std::string_view>& names) {
+    std::vector<std::string_view> unique;
+    unique.reserve(names.size());
+    size_t length = 0;
+    for (std::string_view name : names) {
+        if (!name.empty()) {
+            unique.push_back(name);
+            length += name.size();
+        }
+    }
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    // Copy the names so the trie does not depend on where they came from. The pool is
+    // sized up front; the views into it stay valid.
+    pool.clear();
+    pool.reserve(length);
+    sortedNames.clear();
+    sortedNames.reserve(unique.size());
+    for (std::string_view name : unique) {
+        size_t offset = pool.size();
+        pool.append(name);
+        sortedNames.emplace_back(pool.data() + offset, name.size());
+    }
+
+    nodes.clear();
+    nodes.reserve(length + 1);
+    Node root;
+    root.nameEnd = (uint32_t)sortedNames.size();
+    nodes.push_back(root);
+    buildChildren(0, 0);
+}
+
+// Add the subtree below a node without recursing, allocating each node's children
+// together. Every name below a node at depth d shares its first d characters.
+void CommandTrie::buildChildren(uint32_t root, size_t rootDepth) {
+    std::vector<std::pair<uint32_t, size_t>> pending = {{root, rootDepth}};
+    while (!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+
+        uint32_t begin = nodes[node].nameBegin;
+        uint32_t end = nodes[node].nameEnd;
+
+        // A name ending here sorts before every longer name below the node
+        if (begin < end && sortedNames[begin].size() == depth) {
+            nodes[node].terminal = true;
+            ++begin;
+        }
+
+        // One child per distinct next character; sorted names keep each group contiguous
+        uint32_t firstChild = (uint32_t)nodes.size();
+        for (uint32_t i = begin; i < end;) {
+            Node child;
+            child.label = sortedNames[i][depth];
+            child.nameBegin = i;
+            while (i < end && sortedNames[i][depth] == child.label) {
+                ++i;
+            }
+            child.nameEnd = i;
+            nodes.push_back(child);
+        }
+        nodes[node].firstChild = firstChild;
+        nodes[node].childCount = (uint16_t)(nodes.size() - firstChild);
+
+        for (uint32_t child = firstChild; child < nodes.size(); ++child) {
+            pending.emplace_back(child, depth + 1);
+        }
+    }
+}
+
+// Node reached by following prefix from the root, or nullptr
+const CommandTrie::Node* CommandTrie::walk(std::string_view prefix) const {
+    if (nodes.empty()) {
+        return nullptr;
+    }
+    const Node* node = &nodes[0];
+    for (char c : prefix) {
+        const Node* child = nodes.data() + node->firstChild;
+        const Node* last = child + node->childCount;
+        while (child != last && child->label != c) {
+            ++child;
+        }
+        if (child == last) {
+            return nullptr;
+        }
+        node = child;
+    }
+    return node;
+}
+
+CommandTrie::Range CommandTrie::complete(std::string_view prefix) const {
+    Range range;
+    if (const Node* node = walk(prefix)) {
+        range.first = sortedNames.data() + node->nameBegin;
+        range.last = sortedNames.data() + node->nameEnd;
+    }
+    return range;
+}
+
+bool CommandTrie::contains(std::string_view name) const {
+    const Node* node = walk(name);
+    return node && node->terminal;
+}
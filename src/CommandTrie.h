@@ -0,0 +1,58 @@
+#ifndef COMMANDTRIE_H
+#define COMMANDTRIE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Set of command and cvar names answering prefix queries, for completing actions as they
+// are typed.
+//
+// The names are copied once into one buffer and kept sorted. The trie is a flat array of
+// nodes; the children of a node are contiguous and ordered by label, and every node knows
+// the range of sorted names below it. complete() steps one node per character of the
+// prefix and returns that range, so a query never allocates and never looks at a name
+// that does not match.
+class CommandTrie {
+public:
+    // Names with a common prefix, in sorted order
+    struct Range {
+        const std::string_view* first = nullptr;
+        const std::string_view* last = nullptr;
+
+        const std::string_view* begin() const { return first; }
+        const std::string_view* end() const { return last; }
+        size_t size() const { return (size_t)(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    // Replace the set with the given names; duplicates and empty names are dropped
+    void build(const std::vector<std::string_view>& names);
+
+    // Every name starting with prefix; the empty prefix gives them all
+    Range complete(std::string_view prefix) const;
+
+    bool contains(std::string_view name) const;
+    size_t size() const { return sortedNames.size(); }
+
+private:
+    struct Node {
+        uint32_t firstChild = 0;
+        uint32_t nameBegin = 0; // Range of sortedNames below this node
+        uint32_t nameEnd = 0;
+        uint16_t childCount = 0;
+        char label = 0;
+        bool terminal = false;  // Whether the path to this node is a name itself
+    };
+
+    void buildChildren(uint32_t node, size_t depth);
+    const Node* walk(std::string_view prefix) const;
+
+    std::string pool;                         // Characters of every name
+    std::vector<std::string_view> sortedNames; // Views into pool
+    std::vector<Node> nodes;                  // nodes[0] is the root
+};
+
+#endif // COMMANDTRIE_H
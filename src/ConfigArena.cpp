@@ -0,0 +1,27 @@
+#include "ConfigArena.h"
+#include <algorithm>
+#include <cstdio>
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    inUse += bytes;
+    peak = std::max(peak, inUse);
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    inUse -= bytes;
+}
+
+std::string formatByteCount(size_t bytes) {
+    char text[32];
+    if (bytes < 1024) {
+        snprintf(text, sizeof(text), "%zu B", bytes);
+    } else if (bytes < 1024 * 1024) {
+        snprintf(text, sizeof(text), "%.1f KiB", bytes / 1024.0);
+    } else {
+        snprintf(text, sizeof(text), "%.1f MiB", bytes / (1024.0 * 1024.0));
+    }
+    return text;
+}
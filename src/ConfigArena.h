@@ -0,0 +1,28 @@
+#ifndef CONFIGARENA_H
+#define CONFIGARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// Upstream of the arenas that hold the parsed config model. It takes memory from the heap
+// in the arenas' big blocks and keeps count, so the memory held and its high-water mark
+// can be reported. Not thread-safe: the model is only changed on the main thread.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t bytesInUse() const { return inUse; }
+    size_t highWaterMark() const { return peak; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    size_t inUse = 0;
+    size_t peak = 0;
+};
+
+// Byte count for messages, e.g. "1.5 MiB"
+std::string formatByteCount(size_t bytes);
+
+#endif // CONFIGARENA_H
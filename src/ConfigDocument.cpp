@@ -0,0 +1,87 @@
+#include "ConfigDocument.h"
+#include "AsyncSaver.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <map>
+
+bool ConfigDocument::load(const std::string& filename) {
+    clear();
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+
+    filePath = filename;
+    content.assign(file.data(), file.size());
+    tokenize();
+    loaded = true;
+    return true;
+}
+
+void ConfigDocument::assign(const std::string& filename, std::string text) {
+    filePath = filename;
+    content = std::move(text);
+    tokenize();
+    loaded = true;
+}
+
+void ConfigDocument::clear() {
+    filePath.clear();
+    content.clear();
+    parsedLines.clear();
+    loaded = false;
+}
+
+void ConfigDocument::tokenize() {
+    parsedLines.clear();
+    ConfigLexer lexer(content);
+    ConfigLine line;
+    while (lexer.next(line)) {
+        parsedLines.push_back(line);
+    }
+}
+
+std::string ConfigDocument::applyEdits(std::vector<ConfigEdit> edits, std::string_view appended) const {
+    std::sort(edits.begin(), edits.end(), [](const ConfigEdit& a, const ConfigEdit& b) {
+        return a.offset < b.offset;
+    });
+
+    std::string result;
+    result.reserve(content.size() + appended.size());
+
+    // Copy the untouched text between edits verbatim
+    size_t position = 0;
+    for (const ConfigEdit& edit : edits) {
+        result.append(content, position, edit.offset - position);
+        result += edit.replacement;
+        position = edit.offset + edit.length;
+    }
+    result.append(content, position, std::string::npos);
+
+    if (!appended.empty()) {
+        if (!result.empty() && result.back() != '\n') {
+            result += '\n';
+        }
+        result += appended;
+    }
+    return result;
+}
+
+ConfigDocument& editorDocument(const std::string& path) {
+    static std::map<std::string, ConfigDocument> documents; // Nodes never move
+    return documents[path];
+}
+
+ConfigDocument* queuedSaveDocument(const std::string& path) {
+    static std::map<std::string, ConfigDocument> documents;
+    std::string content;
+    if (!queuedSaveContent(path, content)) {
+        return nullptr;
+    }
+    ConfigDocument& document = documents[path];
+    if (!document.isLoaded() || document.text() != content) {
+        document.assign(path, std::move(content));
+    }
+    return &document;
+}
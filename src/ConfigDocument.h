@@ -0,0 +1,71 @@
+#ifndef CONFIGDOCUMENT_H
+#define CONFIGDOCUMENT_H
+
+#include "ConfigLexer.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Replacement of a byte range of a document
+struct ConfigEdit {
+    size_t offset;
+    size_t length;
+    std::string replacement;
+};
+
+// A .cfg file kept as its original text. Saving patches only the spans of values
+// that changed, so comments, ordering and unknown lines survive byte for byte.
+class ConfigDocument {
+public:
+    ConfigDocument() = default;
+    ConfigDocument(const ConfigDocument&) = delete;
+    ConfigDocument& operator=(const ConfigDocument&) = delete;
+
+    // Read and tokenize a file. On failure the document is left empty.
+    bool load(const std::string& filename);
+
+    // Replace the text, e.g. with the content that was just saved
+    void assign(const std::string& filename, std::string text);
+
+    void clear();
+
+    bool isLoaded() const { return loaded; }
+    const std::string& path() const { return filePath; }
+    const std::string& text() const { return content; }
+
+    // Tokenized lines; their views point into text()
+    const std::vector<ConfigLine>& lines() const { return parsedLines; }
+
+    // Byte offset of a view into text()
+    size_t offsetOf(std::string_view token) const { return static_cast<size_t>(token.data() - content.data()); }
+
+    // Text with the non-overlapping edits applied and extra lines appended at the end
+    std::string applyEdits(std::vector<ConfigEdit> edits, std::string_view appended) const;
+
+private:
+    void tokenize();
+
+    std::string filePath;
+    std::string content;
+    std::vector<ConfigLine> parsedLines;
+    bool loaded = false;
+};
+
+// New content of one file, ready to be written
+struct ConfigSave {
+    std::string path;
+    std::string content;
+};
+
+// Text of a config file as the editors last loaded or saved it. The cvar and control
+// editors share one document per path, so edits from both to the same file patch the same
+// text. The document stays empty until loaded.
+ConfigDocument& editorDocument(const std::string& path);
+
+// Text the latest queued save of a file will leave in it, or nullptr when no save of it is
+// outstanding. Saves diff against it before editorDocument(), so an edit undone while a
+// save waits is written too. Valid until the next call for the same path.
+ConfigDocument* queuedSaveDocument(const std::string& path);
+
+#endif // CONFIGDOCUMENT_H
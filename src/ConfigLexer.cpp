@@ -0,0 +1,78 @@
+#include "ConfigLexer.h"
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static std::string_view trim(std::string_view s) {
+    size_t begin = 0;
+    while (begin < s.size() && isSpace(s[begin])) {
+        ++begin;
+    }
+    size_t end = s.size();
+    while (end > begin && isSpace(s[end - 1])) {
+        --end;
+    }
+    return s.substr(begin, end - begin);
+}
+
+// Split off the first whitespace-delimited word of s, leaving the rest in s
+static std::string_view nextWord(std::string_view& s) {
+    size_t end = 0;
+    while (end < s.size() && !isSpace(s[end])) {
+        ++end;
+    }
+    std::string_view word = s.substr(0, end);
+    s = trim(s.substr(end));
+    return word;
+}
+
+bool ConfigLexer::next(ConfigLine& line) {
+    if (position >= text.size()) {
+        return false;
+    }
+
+    // Find the end of the current line
+    size_t end = text.find('\n', position);
+    if (end == std::string_view::npos) {
+        end = text.size();
+    }
+
+    line = ConfigLine();
+    line.lineNumber = ++lineNumber;
+    line.text = text.substr(position, end - position);
+    if (!line.text.empty() && line.text.back() == '\r') {
+        line.text.remove_suffix(1);
+    }
+    position = end + 1;
+
+    std::string_view content = trim(line.text);
+    if (content.empty()) {
+        line.kind = ConfigLineKind::Blank;
+        return true;
+    }
+
+    if (content[0] == '#') {
+        line.kind = ConfigLineKind::Comment;
+        line.comment = content.substr(1);
+        return true;
+    }
+
+    line.kind = ConfigLineKind::Command;
+    std::string_view rest = content;
+    line.command = nextWord(rest);
+    line.arguments = rest;
+    line.key = nextWord(rest);
+
+    // Extract the first quoted string, if any
+    size_t quoteStart = line.arguments.find('"');
+    if (quoteStart != std::string_view::npos) {
+        size_t quoteEnd = line.arguments.find('"', quoteStart + 1);
+        if (quoteEnd != std::string_view::npos) {
+            line.actions = line.arguments.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
+            line.quoted = true;
+        }
+    }
+
+    return true;
+}
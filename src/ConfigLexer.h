@@ -0,0 +1,41 @@
+#ifndef CONFIGLEXER_H
+#define CONFIGLEXER_H
+
+#include <cstddef>
+#include <string_view>
+
+// Kind of a line in a .cfg file
+enum class ConfigLineKind {
+    Blank,   // Empty or whitespace-only line
+    Comment, // Line starting with '#'
+    Command  // Command followed by optional arguments
+};
+
+// One tokenized line. All views point into the buffer given to the lexer.
+struct ConfigLine {
+    ConfigLineKind kind = ConfigLineKind::Blank;
+    size_t lineNumber = 0;      // 1-based line number
+    std::string_view text;      // Whole line without the line terminator
+    std::string_view command;   // First word (e.g. "bind", "width")
+    std::string_view key;       // Second word (e.g. "+f4", "800")
+    std::string_view arguments; // Everything after the command
+    std::string_view actions;   // Contents of the first quoted string (e.g. load;resetdata)
+    std::string_view comment;   // Text after '#' for comment lines
+    bool quoted = false;        // Whether a complete quoted string was found
+};
+
+// Splits a .cfg buffer into lines without copying it
+class ConfigLexer {
+public:
+    explicit ConfigLexer(std::string_view text) : text(text) {}
+
+    // Tokenize the next line. Returns false at end of input.
+    bool next(ConfigLine& line);
+
+private:
+    std::string_view text;
+    size_t position = 0;
+    size_t lineNumber = 0;
+};
+
+#endif // CONFIGLEXER_H
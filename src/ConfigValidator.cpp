@@ -0,0 +1,272 @@
+#include "ConfigValidator.h"
+#include "BindTable.h"
+#include "ConfigDocument.h"
+#include "ControlsManager.h"
+#include "CvarManager.h"
+#include "CvarCodec.h"
+#include "CvarSchema.h"
+#include "ExecGraph.h"
+#include "KeyNames.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <tuple>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// Whether name is a console command of the game
+static bool isGameCommand(std::string_view name) {
+    static const std::set<std::string_view, std::less<>> commands = [] {
+        std::set<std::string_view, std::less<>> names;
+        for (const CommandSchemaEntry& entry : builtinCommandSchema()) {
+            names.insert(entry.name);
+        }
+        return names;
+    }();
+    return commands.count(name) != 0;
+}
+
+// Split off the next whitespace-separated word of text
+static std::string_view nextWord(std::string_view& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        text = std::string_view();
+        return std::string_view();
+    }
+    size_t end = text.find_first_of(" \t", start);
+    std::string_view word = text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+    text = end == std::string_view::npos ? std::string_view() : text.substr(end);
+    return word;
+}
+
+void ConfigValidator::report(const std::string& filename, size_t line, std::string message) {
+    found.push_back({filename, line, std::move(message)});
+}
+
+// Check a "[a][b]{+|-|*}<key>" token
+void ConfigValidator::validateChord(const std::string& filename, const ConfigLine& line, std::string_view token) {
+    size_t trigger = token.find_first_of("+-*");
+    if (trigger == std::string_view::npos || token.substr(0, trigger).find_first_not_of("ab") != std::string_view::npos) {
+        report(filename, line.lineNumber, "key \"" + std::string(token) + "\" must be [a][b] followed by +, - or * and a key name");
+        return;
+    }
+
+    std::string_view name = token.substr(trigger + 1);
+    if (keyScancode(name) < 0) {
+        report(filename, line.lineNumber, "unknown key \"" + std::string(name) + "\"");
+    }
+}
+
+// Report a bind line that gives a chord different actions than an earlier line did, as the
+// controls editor flags it
+void ConfigValidator::validateOverride(const std::string& filename, const ConfigLine& line) {
+    BindChord chord;
+    if (!parseBindChord(line.key, chord)) {
+        return;
+    }
+    std::string actions;
+    canonicalSignature(line.actions, actions);
+
+    BoundChord& bound = binds[formatBindChord(chord)];
+    if (bound.line != 0 && bound.actions != actions) {
+        report(filename, line.lineNumber, "bind " + std::string(line.key) + " replaces \"" + bound.actions + "\" bound at " +
+                                              bound.file + ":" + std::to_string(bound.line));
+    }
+    bound = {filename, line.lineNumber, std::move(actions)};
+}
+
+// Check the value of a "name value" line against the cvar schema
+void ConfigValidator::validateCvar(const std::string& filename, const ConfigLine& line) {
+    const Cvar& cvar = cvars.find(line.command)->second;
+    if (line.key.empty()) {
+        report(filename, line.lineNumber, "cvar " + std::string(line.command) + " needs a value");
+        return;
+    }
+
+    CvarValue value = cvar.value;
+    if (!parseCvarValue(cvar.type, line.key, value)) {
+        report(filename, line.lineNumber, "\"" + std::string(line.key) + "\" is not a valid " + cvarTypeName(cvar.type) +
+                                              " value for " + std::string(line.command));
+        return;
+    }
+
+    if (!cvarValueInRange(cvar, value)) {
+        Cvar bound = cvar;
+        std::ostringstream message;
+        bound.value = cvar.minValue;
+        message << line.command << " = " << line.key << " is outside [" << formatCvarValue(bound) << ", ";
+        bound.value = cvar.maxValue;
+        message << formatCvarValue(bound) << "]";
+        report(filename, line.lineNumber, message.str());
+    }
+}
+
+void ConfigValidator::validateLine(const std::string& filename, const ConfigLine& line, std::vector<std::string>* execs) {
+    std::string_view command = line.command;
+
+    if (cvars.find(command) != cvars.end()) {
+        validateCvar(filename, line);
+    } else if (command == "bind") {
+        if (line.key.empty()) {
+            report(filename, line.lineNumber, "bind needs a key and a quoted actions string");
+        } else {
+            validateChord(filename, line, line.key);
+            if (!line.quoted) {
+                report(filename, line.lineNumber, "actions of bind " + std::string(line.key) + " must be a quoted string");
+            } else {
+                validateOverride(filename, line);
+            }
+        }
+    } else if (command == "unbind") {
+        if (line.key.empty()) {
+            report(filename, line.lineNumber, "unbind needs a key");
+        } else {
+            validateChord(filename, line, line.key);
+            BindChord chord;
+            if (parseBindChord(line.key, chord)) {
+                binds.erase(formatBindChord(chord));
+            }
+        }
+    } else if (command == "mod") {
+        // "mod a lshift rshift": a modifier group and the keys that hold it
+        std::string_view arguments = line.arguments;
+        std::string_view group = nextWord(arguments);
+        if (group != "a" && group != "b") {
+            report(filename, line.lineNumber, "mod needs modifier group a or b");
+        }
+        for (std::string_view key = nextWord(arguments); !key.empty(); key = nextWord(arguments)) {
+            if (keyScancode(key) < 0) {
+                report(filename, line.lineNumber, "unknown key \"" + std::string(key) + "\"");
+            }
+        }
+    } else if (command == "toggle" || command == "default") {
+        if (cvars.find(line.key) == cvars.end()) {
+            report(filename, line.lineNumber, std::string(command) + " needs a cvar name");
+        }
+    } else if (command == "exec") {
+        std::string target;
+        if (!execTarget(line, target)) {
+            report(filename, line.lineNumber, "exec needs a file name");
+        } else if (execs) {
+            execs->push_back(baseDirectory.empty() ? target : (fs::path(baseDirectory) / target).lexically_normal().generic_string());
+        }
+    } else if (command == "alias") {
+        if (line.key.empty()) {
+            report(filename, line.lineNumber, "alias needs a name");
+        } else {
+            aliases.emplace(line.key);
+        }
+    } else if (!isGameCommand(command) && aliases.find(command) == aliases.end()) {
+        report(filename, line.lineNumber, "unknown command or cvar \"" + std::string(command) + "\"");
+    }
+}
+
+bool ConfigValidator::validate(const std::string& filename, bool followExecs) {
+    size_t before = found.size();
+
+    ConfigDocument document;
+    if (!document.load(filename)) {
+        report(filename, 0, "cannot open file");
+        return false;
+    }
+    visited.insert(filename);
+    stack.push_back(filename);
+
+    std::vector<std::string> execs;
+    for (const ConfigLine& line : document.lines()) {
+        if (line.kind != ConfigLineKind::Command) {
+            continue;
+        }
+
+        execs.clear();
+        validateLine(filename, line, followExecs ? &execs : nullptr);
+
+        // Follow exec lines in place, as the game runs them
+        for (const std::string& target : execs) {
+            if (std::find(stack.begin(), stack.end(), target) != stack.end()) {
+                report(filename, line.lineNumber, "exec cycle through " + target);
+            } else if (!fs::exists(target)) {
+                report(filename, line.lineNumber, "exec target " + target + " not found");
+            } else if (visited.find(target) == visited.end()) {
+                validate(target, true);
+            }
+        }
+    }
+
+    stack.pop_back();
+    return found.size() == before;
+}
+
+bool ConfigValidator::validateFile(const std::string& filename) {
+    return validate(filename, false);
+}
+
+bool ConfigValidator::validateTree(const std::string& rootFilename) {
+    return validate(fs::path(rootFilename).lexically_normal().generic_string(), true);
+}
+
+// Shared state of one validateConfigSets call
+struct ConfigSetScan {
+    WorkStealingPool pool;
+    std::mutex mutex;
+    std::vector<ConfigDiagnostic> diagnostics;
+    size_t treeCount = 0;
+};
+
+// Validate the tree rooted at one autoexec.cfg and merge its diagnostics
+static void validateConfigSet(ConfigSetScan& scan, const fs::path& root) {
+    fs::path base = root.parent_path();
+    if (base.filename() == "cfg") {
+        base = base.parent_path(); // Exec paths are written relative to the game directory
+    }
+
+    ConfigValidator validator(base.generic_string());
+    validator.validateTree(root.generic_string());
+
+    std::lock_guard<std::mutex> lock(scan.mutex);
+    scan.diagnostics.insert(scan.diagnostics.end(), validator.diagnostics().begin(), validator.diagnostics().end());
+    ++scan.treeCount;
+}
+
+// Queue a task for every subdirectory and every tree root in a directory
+static void scanConfigDirectory(ConfigSetScan& scan, const fs::path& directory) {
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        const fs::path path = it->path();
+        if (it->is_directory(ec) && !it->is_symlink(ec)) { // Symlinks could form loops
+            scan.pool.submit([&scan, path] { scanConfigDirectory(scan, path); });
+        } else if (path.filename() == "autoexec.cfg") {
+            scan.pool.submit([&scan, path] { validateConfigSet(scan, path); });
+        }
+    }
+    if (ec) {
+        std::lock_guard<std::mutex> lock(scan.mutex);
+        scan.diagnostics.push_back({directory.generic_string(), 0, "cannot read directory: " + ec.message()});
+    }
+}
+
+std::vector<ConfigDiagnostic> validateConfigSets(const std::vector<std::string>& directories, size_t& treeCount) {
+    ConfigSetScan scan;
+    for (const std::string& directory : directories) {
+        scan.pool.submit([&scan, directory] { scanConfigDirectory(scan, directory); });
+    }
+    scan.pool.wait();
+
+    std::sort(scan.diagnostics.begin(), scan.diagnostics.end(), [](const ConfigDiagnostic& a, const ConfigDiagnostic& b) {
+        return std::tie(a.file, a.line, a.message) < std::tie(b.file, b.line, b.message);
+    });
+    treeCount = scan.treeCount;
+    return std::move(scan.diagnostics);
+}
+
+void printDiagnostics(std::ostream& out, const std::vector<ConfigDiagnostic>& diagnostics) {
+    for (const ConfigDiagnostic& diagnostic : diagnostics) {
+        out << diagnostic.file;
+        if (diagnostic.line != 0) {
+            out << ":" << diagnostic.line;
+        }
+        out << ": " << diagnostic.message << "\n";
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef CONFIGVALIDATOR_H
+#define CONFIGVALIDATOR_H
+
+#include "ConfigLexer.h"
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// One problem found in a config file
+struct ConfigDiagnostic {
+    std::string file;
+    size_t line = 0; // 1-based line number, or 0 for the file as a whole
+    std::string message;
+};
+
+// Checks config files against the cvar schema, bind syntax and key names without applying
+// them. The cvar schema must be loaded first; the cvars map is only read, so validators on
+// different threads may run at the same time.
+class ConfigValidator {
+public:
+    // Exec targets are resolved against baseDirectory, the game directory of the config set.
+    // An empty base resolves them against the working directory, as the game does.
+    explicit ConfigValidator(std::string baseDirectory = std::string()) : baseDirectory(std::move(baseDirectory)) {}
+
+    // Check one file without following its exec lines. Returns false if it has problems.
+    bool validateFile(const std::string& filename);
+
+    // Check the tree rooted at rootFilename, following exec lines. Each file is checked once.
+    bool validateTree(const std::string& rootFilename);
+
+    const std::vector<ConfigDiagnostic>& diagnostics() const { return found; }
+
+private:
+    bool validate(const std::string& filename, bool followExecs);
+    void validateLine(const std::string& filename, const ConfigLine& line, std::vector<std::string>* execs);
+    void validateChord(const std::string& filename, const ConfigLine& line, std::string_view token);
+    void validateOverride(const std::string& filename, const ConfigLine& line);
+    void validateCvar(const std::string& filename, const ConfigLine& line);
+    void report(const std::string& filename, size_t line, std::string message);
+
+    // The bind line a chord was last bound by
+    struct BoundChord {
+        std::string file;
+        size_t line = 0;
+        std::string actions; // Canonical actions string
+    };
+
+    std::string baseDirectory;
+    std::vector<ConfigDiagnostic> found;
+    std::map<std::string, BoundChord> binds;    // By formatted chord, e.g. "a+f5"
+    std::set<std::string, std::less<>> aliases; // Names defined by alias lines so far
+    std::set<std::string> visited;              // Files already checked
+    std::vector<std::string> stack;             // Files being checked, for cycle reports
+};
+
+// Validate every config tree (each autoexec.cfg) below the given directories, spreading the
+// directory walk and the trees over a work-stealing pool. Exec targets of a tree in a "cfg"
+// directory are resolved against the directory above it. Returns the merged diagnostics
+// sorted by file and line.
+std::vector<ConfigDiagnostic> validateConfigSets(const std::vector<std::string>& directories, size_t& treeCount);
+
+// Print diagnostics as "file:line: message", one per line
+void printDiagnostics(std::ostream& out, const std::vector<ConfigDiagnostic>& diagnostics);
+
+#endif // CONFIGVALIDATOR_H
@@ -1,13 +1,23 @@
 #include "ControlsManager.h"
 #include "imgui.h"
-#include "keystr.h"
-#include <fstream>
-#include <sstream>
+#include "KeyNames.h"
+#include "BindTable.h"
+#include "ConfigLexer.h"
+#include "ConfigDocument.h"
+#include "AsyncSaver.h"
+#include "EditHistory.h"
+#include "CommandTrie.h"
+#include "CvarSchema.h"
+#include "ExecGraph.h"
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <SDL.h>
 
 // Map to store control bindings
-std::map<std::string, ControlBinding> controls = {
+StringMap<ControlBinding> controls = {
     {"throttle", {"throttle", "up", "*", {"throttle", "spy_up"}, "Throttle"}},
     {"brake", {"brake", "down", "*", {"brake", "spy_down"}, "Brake"}},
     {"brake_alias", {"brake_alias", "", "*", {"brake"}, "Brake alias"}},
@@ -25,165 +35,874 @@ std::vector<ControlSection> controlSections = {
     {"# Saveload Controls", {"save", "load"}}
 };
 
-void parseControlLine(const std::string& line, ControlSection& currentSection) {
-    std::istringstream iss(line);
-    std::string bind, key, actions;
+// Index from canonical action signature (e.g. "load;resetdata") to the binding it belongs to
+static std::unordered_map<std::string, ControlBinding*> actionIndex;
+static bool actionIndexBuilt = false;
 
-    // Extract the "bind" keyword and the key
-    if (!(iss >> bind >> key)) {
-        return; // Skip invalid lines
+// Build the canonical signature of a semicolon-separated actions string into out
+void canonicalSignature(std::string_view actions, std::string& out) {
+    out.clear();
+    size_t position = 0;
+    while (true) {
+        size_t end = actions.find(';', position);
+        std::string_view action = actions.substr(position, end == std::string_view::npos ? std::string_view::npos : end - position);
+
+        // Ignore whitespace around each action
+        while (!action.empty() && (action.front() == ' ' || action.front() == '\t')) action.remove_prefix(1);
+        while (!action.empty() && (action.back() == ' ' || action.back() == '\t')) action.remove_suffix(1);
+        out += action;
+
+        if (end == std::string_view::npos) {
+            break;
+        }
+        out += ';';
+        position = end + 1;
     }
+}
 
-    // Find the position of the first double quote
-    size_t quoteStart = line.find('"');
-    if (quoteStart == std::string::npos) {
-        return; // No actions found
+// Build the canonical signature of a binding's action list
+static std::string canonicalSignature(const std::vector<std::string>& actions) {
+    std::string signature;
+    for (size_t i = 0; i < actions.size(); ++i) {
+        signature += actions[i];
+        if (i < actions.size() - 1) {
+            signature += ";";
+        }
     }
+    return signature;
+}
 
-    // Find the position of the second double quote
-    size_t quoteEnd = line.find('"', quoteStart + 1);
-    if (quoteEnd == std::string::npos) {
-        return; // No closing quote found
+// Rebuild the action index from the controls map. The first binding wins on duplicate signatures.
+static void rebuildActionIndex() {
+    actionIndex.clear();
+    actionIndex.reserve(controls.size());
+    for (auto& [name, binding] : controls) {
+        actionIndex.emplace(canonicalSignature(binding.actions), &binding);
     }
+    actionIndexBuilt = true;
+}
 
-    // Extract the actions string between the quotes
-    actions = line.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
+// Look up the binding whose actions match the given actions string
+static ControlBinding* findControlByActions(std::string_view actions) {
+    if (!actionIndexBuilt) {
+        rebuildActionIndex();
+    }
 
-    // Match the command to the controls map
-    for (auto& [name, binding] : controls) {
-        // Combine binding.actions into a semicolon-separated string
-        std::string combinedActions;
-        for (size_t i = 0; i < binding.actions.size(); ++i) {
-            combinedActions += binding.actions[i];
-            if (i < binding.actions.size() - 1) {
-                combinedActions += ";";
+    static std::string signature; // Reused so lookups do not allocate
+    canonicalSignature(actions, signature);
+    auto it = actionIndex.find(signature);
+    return it != actionIndex.end() ? it->second : nullptr;
+}
+
+// Actions of each edited binding as the controls file still has them, so a save can find
+// the line to rewrite
+static std::map<const ControlBinding*, std::string> fileActions;
+
+// Look up an edited binding by the actions its line in the file still has
+static ControlBinding* findEditedControl(std::string_view actions) {
+    if (fileActions.empty()) {
+        return nullptr;
+    }
+    std::string signature;
+    canonicalSignature(actions, signature);
+    for (const auto& [binding, original] : fileActions) {
+        if (original == signature) {
+            return const_cast<ControlBinding*>(binding);
+        }
+    }
+    return nullptr;
+}
+
+bool setControlActions(const std::string& command, const std::vector<std::string>& actions) {
+    auto it = controls.find(command);
+    if (it == controls.end()) {
+        return false;
+    }
+
+    ControlBinding& binding = it->second;
+    std::string before = canonicalSignature(binding.actions);
+    std::string after = canonicalSignature(actions);
+
+    // Bind lines are matched to controls by their actions, so two controls cannot share them
+    if (after != before) {
+        for (const auto& [name, other] : controls) {
+            if (&other != &binding && canonicalSignature(other.actions) == after) {
+                return false;
             }
         }
+    }
 
-        // Compare the combined actions with the actions string
-        if (combinedActions == actions) {
-            binding.key = key.substr(1);       // Extract the key
-            binding.modifiers = key.substr(0, 1); // Extract the modifier
-            break;
+    binding.actions = actions;
+    if (actionIndexBuilt) {
+        auto indexed = actionIndex.find(before);
+        if (indexed != actionIndex.end() && indexed->second == &binding) {
+            actionIndex.erase(indexed);
+
+            // A control with the same actions that the index shadowed takes the place
+            for (auto& [name, other] : controls) {
+                if (&other != &binding && canonicalSignature(other.actions) == before) {
+                    actionIndex.emplace(before, &other);
+                    break;
+                }
+            }
+        }
+        actionIndex.emplace(after, &binding);
+    }
+
+    // The first edit since the last save remembers what the file has
+    fileActions.emplace(&binding, before);
+
+    BindChord chord;
+    if (parseBindChord(binding.modifiers + binding.key, chord)) {
+        bindTable.rebind(chord, before, after);
+    }
+    return true;
+}
+
+bool setControlActions(const std::string& command, std::string_view actions) {
+    std::vector<std::string> split;
+    std::string signature;
+    canonicalSignature(actions, signature);
+    size_t position = 0;
+    while (position <= signature.size()) {
+        size_t end = std::min(signature.find(';', position), signature.size());
+        if (end > position) {
+            split.emplace_back(signature, position, end - position);
         }
+        position = end + 1;
+    }
+    return setControlActions(command, split);
+}
+
+// Length of the "[a][b]{+|-|*}" prefix of a bind key token, or 0 if it has none
+static size_t bindPrefixLength(std::string_view token) {
+    size_t trigger = token.find_first_of("+-*");
+    return trigger == std::string_view::npos ? 0 : trigger + 1;
+}
+
+// Returns whether the line went into the bind table
+bool parseControlLine(const ConfigLine& line, ControlSection& currentSection, const std::string& file) {
+    (void)currentSection;
+
+    // Only "bind <key> "<actions>"" lines are of interest
+    if (line.command != "bind" || line.key.empty() || !line.quoted) {
+        return false; // Skip invalid lines
+    }
+    size_t prefixLength = bindPrefixLength(line.key);
+    if (prefixLength == 0) {
+        return false; // No trigger
+    }
+
+    // Every bind line goes into the bind table, remembering where it came from
+    BindChord chord;
+    bool bound = parseBindChord(line.key, chord);
+    if (bound) {
+        static std::string signature; // Reused so loading does not allocate per line
+        canonicalSignature(line.actions, signature);
+        bindTable.bind(chord, signature, file, line.lineNumber);
+    }
+
+    // Match the command to the controls map
+    if (ControlBinding* binding = findControlByActions(line.actions)) {
+        binding->key = line.key.substr(prefixLength);          // Extract the key
+        binding->modifiers = line.key.substr(0, prefixLength); // Extract the modifiers and trigger
+        binding->file = file;
     }
+    return bound;
 }
 
+// Apply a "bind" line to the binding with the same actions
+bool applyControlLine(const ConfigLine& line, const std::string& file) {
+    return parseControlLine(line, controlSections[0], file);
+}
+
+// Whether the completion names need rebuilding for new aliases
+static bool actionNamesStale = true;
+
 // Function to load controls from controls.cfg
 bool loadControls(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    ConfigDocument& document = editorDocument(filename);
+    if (!document.load(filename)) {
         std::cerr << "Failed to open " << filename << std::endl;
         return false;
     }
+    fileActions.clear();
+    clearEditHistory(); // Undo must not bring back keys from before the load
 
-    std::string line;
-    while (std::getline(file, line)) {
+    for (const ConfigLine& line : document.lines()) {
         // Skip comments and empty lines
-        if (line.empty() || line[0] == '#') {
+        if (line.kind != ConfigLineKind::Command) {
             continue;
         }
 
         // Parse the line
-        parseControlLine(line, controlSections[0]); // Pass the first section for simplicity
+        parseControlLine(line, controlSections[0], filename); // Pass the first section for simplicity
     }
 
-    file.close();
     return true;
 }
 
-// Function to save controls to controls.cfg
-bool saveControls(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open " << filename << " for writing." << std::endl;
-        return false;
+// Key token of the last bind line of each named binding in a document
+static std::map<ControlBinding*, std::string_view> lastControlTokens(const ConfigDocument& document) {
+    std::map<ControlBinding*, std::string_view> tokens;
+    for (const ConfigLine& line : document.lines()) {
+        if (line.command == "bind" && line.quoted && bindPrefixLength(line.key) != 0) {
+            if (ControlBinding* binding = findControlByActions(line.actions)) {
+                tokens[binding] = line.key;
+            }
+        }
     }
+    return tokens;
+}
 
+// Apply what changed between two versions of a config file to the bind table and the
+// named bindings. A binding rebound in the editor since the file was last read keeps the
+// editor's key, and one bound by a file executed later keeps that file's key. Returns the number of named bindings changed.
+size_t mergeControlChanges(const std::string& filename, const ConfigDocument& before, const ConfigDocument& after) {
+    // The file's bind lines are replaced as a whole at its place in exec order; lines of
+    // other files stay
+    bindTable.unbindFile(filename);
+    auto runsLater = [&](std::string_view file) { return execsAfter(file, filename); };
+    std::string signature;
+    for (const ConfigLine& line : after.lines()) {
+        BindChord chord;
+        if (line.command == "bind" && line.quoted && parseBindChord(line.key, chord)) {
+            canonicalSignature(line.actions, signature);
+            bindTable.bindInOrder(chord, signature, filename, line.lineNumber, runsLater);
+        }
+    }
+
+    std::map<ControlBinding*, std::string_view> oldTokens = lastControlTokens(before);
+    size_t changes = 0;
+    for (const auto& [binding, token] : lastControlTokens(after)) {
+        std::string current = binding->modifiers + binding->key;
+        auto old = oldTokens.find(binding);
+        if (old != oldTokens.end() && current != old->second) {
+            // Rebound here since: keep the editor's key, also in the bind table
+            BindChord fileChord, editorChord;
+            if (parseBindChord(token, fileChord) && parseBindChord(current, editorChord)) {
+                std::string actions = canonicalSignature(binding->actions);
+                bindTable.move(fileChord, editorChord, actions);
+                if (binding->command == "load") {
+                    fileChord.trigger = BindTrigger::Hold;
+                    editorChord.trigger = BindTrigger::Hold;
+                    bindTable.move(fileChord, editorChord, "hold");
+                }
+            }
+            continue;
+        }
+
+        if (current != token && (binding->file.empty() || !runsLater(binding->file))) {
+            size_t prefixLength = bindPrefixLength(token);
+            binding->key = token.substr(prefixLength);
+            binding->modifiers = token.substr(0, prefixLength);
+            binding->file = filename;
+            ++changes;
+        }
+    }
+
+    actionNamesStale = true; // Aliases may have changed
+    return changes;
+}
+
+// Append the line(s) of one binding in .cfg format
+static void appendControlLines(std::string& out, const std::string& command, const ControlBinding& binding) {
+    // Write the primary binding to the file
+    out += "bind " + binding.modifiers + binding.key + " \"" + canonicalSignature(binding.actions) + "\"\n";
+
+    // Special case: Write an additional line for the "load" key
+    if (command == "load" && !binding.key.empty()) {
+        out += "bind *" + binding.key + " \"hold\"\n";
+    }
+}
+
+// Render the control sections in .cfg format, with only the bindings in owned if given
+static std::string serializeControlSections(const std::set<const ControlBinding*>* owned) {
+    std::string file;
     for (const auto& section : controlSections) {
         // Write the section heading
-        file << section.heading << std::endl;
+        file += section.heading + "\n";
 
         // Write the bindings in this section
         for (const auto& command : section.commands) {
-            const auto& binding = controls[command];
-
-            // Combine actions into a single string
-            std::string actions;
-            for (size_t i = 0; i < binding.actions.size(); ++i) {
-                actions += binding.actions[i];
-                if (i < binding.actions.size() - 1) {
-                    actions += ";";
+            auto binding = controls.find(command);
+            if (binding != controls.end() && (!owned || owned->count(&binding->second) != 0)) {
+                appendControlLines(file, command, binding->second);
+            }
+        }
+
+        file += "\n"; // Add a blank line between sections
+    }
+    return file;
+}
+
+// Render the control sections in .cfg format
+std::string serializeControls() {
+    return serializeControlSections(nullptr);
+}
+
+// Render every bind table entry in .cfg format, in the order they were bound
+std::string serializeBinds() {
+    std::string file;
+    bindTable.forEach([&](const BindChord& chord, const std::pmr::string& actions) {
+        file += "bind " + formatBindChord(chord) + " \"";
+        file += actions;
+        file += "\"\n";
+    });
+    return file;
+}
+
+// Build the content of one file from the named bindings it owns. An existing file keeps
+// its text and only the key tokens of rebound controls (and the actions of edited ones)
+// are rewritten; bound controls it does not mention are appended. A new file gets the
+// sections with the bindings it owns. Returns false when the file would not change and
+// no save of it is queued; a queued save is always replaced.
+static bool prepareControlsFile(const std::string& filename, const std::set<const ControlBinding*>& owned, std::string& content) {
+    ConfigDocument* queued = queuedSaveDocument(filename);
+    ConfigDocument& document = queued ? *queued : editorDocument(filename);
+    if (!document.isLoaded() && !document.load(filename)) {
+        content = serializeControlSections(&owned);
+        return true;
+    }
+
+    // Find the line each binding was loaded from; the last match wins as in loadControls
+    std::map<const ControlBinding*, const ConfigLine*> sourceLines;
+    std::vector<const ConfigLine*> holdLines;
+    for (const ConfigLine& line : document.lines()) {
+        if (line.command != "bind" || line.key.empty() || !line.quoted) {
+            continue;
+        }
+        ControlBinding* binding = findControlByActions(line.actions);
+        if (!binding) {
+            binding = findEditedControl(line.actions);
+        }
+        if (binding) {
+            sourceLines[binding] = &line;
+        } else if (line.actions == "hold") {
+            holdLines.push_back(&line);
+        }
+    }
+
+    std::vector<ConfigEdit> edits;
+    std::string appended;
+    for (const auto& section : controlSections) {
+        for (const auto& command : section.commands) {
+            auto named = controls.find(command);
+            if (named == controls.end() || owned.count(&named->second) == 0) {
+                continue;
+            }
+            const ControlBinding& binding = named->second;
+            auto source = sourceLines.find(&binding);
+            if (source == sourceLines.end()) {
+                if (!binding.key.empty()) {
+                    appendControlLines(appended, command, binding);
                 }
+                continue;
             }
 
-            // Write the primary binding to the file
-            file << "bind " << binding.modifiers << binding.key << " \"" << actions << "\"" << std::endl;
+            // Rewrite the actions of a line whose binding was edited
+            std::string_view actions = source->second->actions;
+            std::string newActions = canonicalSignature(binding.actions);
+            if (fileActions.count(&binding) != 0 && actions != newActions) {
+                edits.push_back({document.offsetOf(actions), actions.size(), newActions});
+            }
 
-            // Special case: Write an additional line for the "load" key
-            if (command == "load" && !binding.key.empty()) {
-                file << "bind *" << binding.key << " \"hold\"" << std::endl;
+            std::string_view token = source->second->key;
+            std::string newToken = binding.modifiers + binding.key;
+            if (binding.key.empty() || token == newToken) {
+                continue;
             }
-        }
+            edits.push_back({document.offsetOf(token), token.size(), newToken});
 
-        file << std::endl; // Add a blank line between sections
+            // Move the "hold" line that followed the old load key along with it
+            if (command == "load") {
+                for (const ConfigLine* hold : holdLines) {
+                    if (hold->key.substr(bindPrefixLength(hold->key)) == token.substr(bindPrefixLength(token))) {
+                        edits.push_back({document.offsetOf(hold->key), hold->key.size(), "*" + binding.key});
+                    }
+                }
+            }
+        }
     }
 
-    file.close();
+    if (edits.empty() && appended.empty() && !queued) {
+        return false;
+    }
+    content = document.applyEdits(std::move(edits), appended);
     return true;
 }
 
+// A file to write, and the actions its edited bindings have in it
+struct ControlsSave {
+    ConfigSave file;
+    std::map<const ControlBinding*, std::string> editedActions;
+};
+
+// Later saves patch what was written, and edits the file now has are no longer edits.
+// Only called once the file is on disk, so a failed write leaves both as they were.
+static void controlsFileSaved(const std::string& filename, const std::string& content,
+                              const std::map<const ControlBinding*, std::string>& editedActions) {
+    editorDocument(filename).assign(filename, content);
+    for (const auto& [binding, actions] : editedActions) {
+        if (canonicalSignature(binding->actions) == actions) {
+            fileActions.erase(binding);
+        } else {
+            fileActions[binding] = actions; // Edited again while the save was queued
+        }
+    }
+}
+
+// Build the files to write for a save to filename. A binding is written back to the file
+// its key was last bound in, which the game also runs last, so an edit is not overridden
+// by a later exec; bindings no file has bound go to filename.
+static std::vector<ControlsSave> prepareControlsSave(const std::string& filename) {
+    std::map<std::string_view, std::set<const ControlBinding*>> owned;
+    for (const auto& [name, binding] : controls) {
+        owned[binding.file.empty() ? std::string_view(filename) : std::string_view(binding.file)].insert(&binding);
+    }
+
+    std::vector<ControlsSave> saves;
+    for (const auto& [file, bindings] : owned) {
+        ControlsSave save;
+        save.file.path = std::string(file);
+        if (!prepareControlsFile(save.file.path, bindings, save.file.content)) {
+            continue;
+        }
+        for (const ControlBinding* binding : bindings) {
+            if (fileActions.count(binding) != 0) {
+                save.editedActions[binding] = canonicalSignature(binding->actions);
+            }
+        }
+        saves.push_back(std::move(save));
+    }
+    return saves;
+}
+
+// Function to save controls to controls.cfg
+bool saveControls(const std::string& filename) {
+    bool ok = true;
+    for (const ControlsSave& save : prepareControlsSave(filename)) {
+        if (writeFileAtomically(save.file.path, save.file.content)) {
+            controlsFileSaved(save.file.path, save.file.content, save.editedActions);
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Save a snapshot of the controls on the background writer
+void queueControlsSave(const std::string& filename) {
+    for (ControlsSave& save : prepareControlsSave(filename)) {
+        std::string path = save.file.path;
+        queueSave(save.file.path, std::move(save.file.content),
+                  [path, editedActions = std::move(save.editedActions)](const std::string& content) {
+                      controlsFileSaved(path, content, editedActions);
+                  });
+    }
+}
+
 // Static variables for keybinding state
 static std::string activeBinding = ""; // Command currently being edited
 static bool waitingForKey = false;     // Whether we are waiting for a key press
 
+// Give a named binding a new key token (e.g. "a+f5"), keeping the bind table in step
+bool setControlKey(const std::string& command, std::string_view token) {
+    auto it = controls.find(command);
+    if (it == controls.end()) {
+        return false;
+    }
+    ControlBinding& binding = it->second;
+
+    BindChord oldChord;
+    parseBindChord(binding.modifiers + binding.key, oldChord); // Stays invalid for an unbound control
+
+    size_t prefixLength = bindPrefixLength(token);
+    binding.modifiers = token.substr(0, prefixLength);
+    binding.key = token.substr(prefixLength);
+
+    // An empty or invalid token unbinds the old chord
+    BindChord newChord;
+    parseBindChord(token, newChord);
+    std::string actions = canonicalSignature(binding.actions);
+    bindTable.move(oldChord, newChord, actions);
+
+    // The "hold" bind follows the load key
+    if (command == "load") {
+        BindChord oldHold = oldChord;
+        BindChord newHold = newChord;
+        oldHold.trigger = BindTrigger::Hold;
+        newHold.trigger = BindTrigger::Hold;
+        bindTable.move(oldHold, newHold, "hold");
+    }
+    return true;
+}
+
 // Function to process keybinding-related events
 void processKeybindingEvents(const SDL_Event& event) {
     if (waitingForKey && event.type == SDL_KEYDOWN) {
         int keycode = event.key.keysym.scancode; // Get the SDL scancode
-        if (!activeBinding.empty() && controls.find(activeBinding) != controls.end()) {
-            controls[activeBinding].key = keystr[keycode]; // Update the keybinding with the key string
+        if (keyName(keycode).empty()) {
+            return; // Not a key we can write to a config; keep waiting
+        }
+        auto named = controls.find(activeBinding);
+        if (named != controls.end()) {
+            ControlBinding& binding = named->second;
+            std::string before = binding.modifiers + binding.key;
+
+            // Update the keybinding with the key string
+            setControlKey(activeBinding, binding.modifiers + std::string(keyName(keycode)));
+            recordControlEdit(activeBinding, before, binding.modifiers + binding.key);
+
             waitingForKey = false;                        // Stop listening for key presses
             activeBinding = "";                           // Clear the active binding
         }
     }
 }
 
+// Whether the editor is waiting for a key press to complete a binding
+bool isCapturingKey() {
+    return waitingForKey;
+}
+
+// List every place the key of a conflicting chord is bound, under any trigger
+static void renderConflictTooltip(const BindChord& chord) {
+    ImGui::BeginTooltip();
+    ImGui::Text("%s is bound to different actions:", formatBindChord(chord).c_str());
+    if (const std::pmr::vector<BindSource>* sources = bindTable.sources(chord)) {
+        for (const BindSource& source : *sources) {
+            if (source.file.empty()) {
+                ImGui::BulletText("editor: \"%s\"", source.actions.c_str());
+            } else {
+                ImGui::BulletText("%s:%zu: \"%s\"", source.file.c_str(), source.line, source.actions.c_str());
+            }
+        }
+    }
+    ImGui::EndTooltip();
+}
+
+void invalidateActionNames() {
+    actionNamesStale = true;
+}
+
+// Names an action may start with: the game's commands, the cvars and the aliases of the
+// loaded config files. Rebuilt when the cvar set or the config files change.
+static const CommandTrie& actionNames() {
+    static CommandTrie trie;
+    static size_t cvarCount = 0;
+    if (actionNamesStale || cvarCount != cvars.size()) {
+        std::vector<std::string> aliases = configTreeAliases();
+        std::vector<std::string_view> names;
+        names.reserve(builtinCommandSchema().size() + cvars.size());
+        for (const CommandSchemaEntry& entry : builtinCommandSchema()) {
+            names.push_back(entry.name);
+        }
+        for (const auto& [name, cvar] : cvars) {
+            names.push_back(name);
+        }
+        names.insert(names.end(), aliases.begin(), aliases.end());
+        trie.build(names);
+        cvarCount = cvars.size();
+        actionNamesStale = false;
+    }
+    return trie;
+}
+
+// Command word of one action, e.g. "slot" for "slot 1"
+static std::string_view actionCommand(std::string_view action) {
+    size_t start = action.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return std::string_view();
+    }
+    size_t end = action.find_first_of(" \t", start);
+    return action.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+}
+
+// Call fn with the command word of every action in a "a;b;c" string that is not a known name
+template <typename Fn>
+static void forEachUnknownAction(std::string_view actions, Fn fn) {
+    const CommandTrie& names = actionNames();
+    size_t position = 0;
+    while (position <= actions.size()) {
+        size_t end = std::min(actions.find(';', position), actions.size());
+        std::string_view command = actionCommand(actions.substr(position, end - position));
+        if (!command.empty() && !names.contains(command)) {
+            fn(command);
+        }
+        position = end + 1;
+    }
+}
+
+// State of the actions editor popup
+static std::string actionsCommand;    // Binding being edited, or empty
+static std::string actionsText;       // Grown by the input as it is typed into
+static int actionsCursor = 0;         // Cursor position in actionsText
+static int placeCursor = -1;          // Cursor position to set when the input is focused
+static bool openActionsEditor = false;
+static bool focusActionsInput = false;
+static bool actionsTaken = false;     // Whether Apply found the actions in use by another binding
+
+// Command word being typed before the cursor as [start, cursor), or false when the cursor
+// is in an action's arguments
+static bool typedCommand(const char* text, int cursor, int& start) {
+    start = cursor;
+    while (start > 0 && text[start - 1] != ';') {
+        --start;
+    }
+    while (start < cursor && (text[start] == ' ' || text[start] == '\t')) {
+        ++start;
+    }
+    for (int i = start; i < cursor; ++i) {
+        if (text[i] == ' ' || text[i] == '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Track the cursor, and complete the command word before it on Tab: a single match is
+// completed in full, several are completed up to what they have in common
+static int actionsInputCallback(ImGuiInputTextCallbackData* data) {
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+        actionsText.resize((size_t)data->BufTextLen);
+        data->Buf = actionsText.data();
+        return 0;
+    }
+
+    // Focusing the input selects its text; put the cursor where editing left off instead
+    if (placeCursor >= 0) {
+        data->CursorPos = std::min(placeCursor, data->BufTextLen);
+        data->SelectionStart = data->SelectionEnd = data->CursorPos;
+        placeCursor = -1;
+    }
+    actionsCursor = data->CursorPos;
+    if (data->EventFlag != ImGuiInputTextFlags_CallbackCompletion) {
+        return 0;
+    }
+
+    int start;
+    if (!typedCommand(data->Buf, data->CursorPos, start)) {
+        return 0;
+    }
+    std::string_view typed(data->Buf + start, (size_t)(data->CursorPos - start));
+    CommandTrie::Range matches = actionNames().complete(typed);
+    if (matches.empty()) {
+        return 0;
+    }
+
+    // Sorted names share the prefix common to the first and the last
+    std::string_view first = *matches.begin();
+    std::string_view last = *(matches.end() - 1);
+    size_t common = typed.size();
+    while (common < first.size() && common < last.size() && first[common] == last[common]) {
+        ++common;
+    }
+    if (common > typed.size()) {
+        std::string completion(first.substr(typed.size(), common - typed.size()));
+        if (matches.size() == 1) {
+            completion += ' ';
+        }
+        data->InsertChars(data->CursorPos, completion.c_str());
+    }
+    actionsCursor = data->CursorPos;
+    return 0;
+}
+
+// Replace the command word before the cursor with name, after a suggestion is clicked
+static void acceptSuggestion(std::string_view name) {
+    int start;
+    if (!typedCommand(actionsText.c_str(), actionsCursor, start)) {
+        return;
+    }
+    std::string text(actionsText, 0, (size_t)start);
+    text += name;
+    text += ' ';
+    int cursor = (int)text.size();
+    text.append(actionsText, (size_t)actionsCursor);
+    actionsText = std::move(text);
+    actionsCursor = cursor;
+    placeCursor = actionsCursor;
+    focusActionsInput = true;
+}
+
+// Apply the edited actions to their binding. Returns false if another binding has them.
+static bool applyActionsEdit() {
+    auto named = controls.find(actionsCommand);
+    if (named == controls.end()) {
+        return true;
+    }
+    std::string before = canonicalSignature(named->second.actions);
+    if (!setControlActions(actionsCommand, actionsText)) {
+        return false;
+    }
+    recordActionsEdit(actionsCommand, before, canonicalSignature(named->second.actions));
+    return true;
+}
+
+// Render the actions editor popup of the binding in actionsCommand
+static void renderActionsEditor() {
+    auto named = controls.find(actionsCommand);
+    if (named == controls.end()) {
+        ImGui::CloseCurrentPopup();
+        return;
+    }
+
+    ImGui::Text("Actions of %s, separated by ';'. Tab completes a command.", named->second.uiName.c_str());
+    if (focusActionsInput) {
+        ImGui::SetKeyboardFocusHere();
+        focusActionsInput = false;
+    }
+    ImGui::SetNextItemWidth(320.0f);
+    bool apply = ImGui::InputText("##actions", actionsText.data(), actionsText.capacity() + 1,
+                                  ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackAlways |
+                                      ImGuiInputTextFlags_CallbackResize,
+                                  actionsInputCallback);
+
+    // Names starting with the command word being typed
+    int start;
+    if (typedCommand(actionsText.c_str(), actionsCursor, start) && start < actionsCursor) {
+        std::string_view typed(actionsText.c_str() + start, (size_t)(actionsCursor - start));
+        CommandTrie::Range matches = actionNames().complete(typed);
+        const size_t shown = 8;
+        size_t count = 0;
+        for (std::string_view name : matches) {
+            if (count++ == shown) {
+                ImGui::TextDisabled("... %zu more", matches.size() - shown);
+                break;
+            }
+            if (name == typed) {
+                continue;
+            }
+            if (ImGui::Selectable(std::string(name).c_str())) {
+                acceptSuggestion(name);
+            }
+        }
+    }
+
+    forEachUnknownAction(actionsText, [](std::string_view command) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Unknown command or cvar \"%.*s\"", (int)command.size(), command.data());
+    });
+
+    if (actionsTaken) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Another control already has these actions");
+    }
+
+    ImGui::Separator();
+    if (ImGui::Button("Apply") || apply) {
+        actionsTaken = !applyActionsEdit();
+        if (!actionsTaken) {
+            ImGui::CloseCurrentPopup();
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Cancel")) {
+        ImGui::CloseCurrentPopup();
+    }
+}
+
+// Render the key button of one binding
+static void renderControlRow(const std::string& command) {
+    auto named = controls.find(command);
+    if (named == controls.end()) {
+        return;
+    }
+    const ControlBinding& binding = named->second;
+
+    // Chord of the binding, reusing one buffer across rows
+    static std::string token;
+    token = binding.modifiers;
+    token += binding.key;
+    BindChord chord;
+    bool conflicted = parseBindChord(token, chord) && bindTable.hasConflict(chord);
+
+    ImGui::PushID(command.c_str());
+    ImGui::Text("%s:", binding.uiName.c_str()); // Use uiName for display
+    ImGui::SameLine();
+
+    if (conflicted) {
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7f, 0.2f, 0.2f, 1.0f));
+    }
+    const char* keyLabel = binding.key.empty() ? "Unbound" : binding.key.c_str();
+    if (ImGui::Button(keyLabel)) {
+        activeBinding = command;
+        waitingForKey = true;
+    }
+    if (conflicted) {
+        ImGui::PopStyleColor();
+        if (ImGui::IsItemHovered()) {
+            renderConflictTooltip(chord);
+        }
+    }
+
+    // Actions, flagged when one is not a known command
+    static std::string actions;
+    actions = canonicalSignature(binding.actions);
+    bool unknown = false;
+    forEachUnknownAction(actions, [&](std::string_view) { unknown = true; });
+    ImGui::SameLine();
+    if (unknown) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+    }
+    if (ImGui::SmallButton(actions.c_str())) {
+        actionsCommand = command;
+        actionsText = actions;
+        actionsCursor = (int)actionsText.size();
+        actionsTaken = false;
+        placeCursor = actionsCursor;
+        openActionsEditor = true;
+        focusActionsInput = true;
+    }
+    if (unknown) {
+        ImGui::PopStyleColor();
+    }
+
+    if (waitingForKey && activeBinding == command) {
+        ImGui::SameLine();
+        ImGui::Text("Press a key...");
+    }
+    ImGui::PopID();
+}
+
 // Function to render the controls editor
 void renderControlsEditor() {
     ImGui::Begin("Controls Editor");
 
     ImGui::Text("Press a key to bind it to a command.");
+    if (bindTable.conflictCount() > 0) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%zu chord(s) bound to different actions in more than one place",
+                           bindTable.conflictCount());
+    }
     ImGui::Separator();
 
     for (const auto& section : controlSections) {
-        // Display the section heading
-        ImGui::Text("%s", section.heading.c_str());
-        ImGui::Separator();
-
-        // Display the bindings in this section
-        for (const auto& command : section.commands) {
-            auto& binding = controls[command];
-
-            ImGui::Text("%s:", binding.uiName.c_str()); // Use uiName for display
-            ImGui::SameLine();
-
-            std::string keyName = binding.key.empty() ? "Unbound" : binding.key;
-            if (ImGui::Button(keyName.c_str())) {
-                activeBinding = command;
-                waitingForKey = true;
-            }
+        // Display the section heading as a collapsible group
+        if (!ImGui::CollapsingHeader(section.heading.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+            continue;
+        }
 
-            if (waitingForKey && activeBinding == command) {
-                ImGui::SameLine();
-                ImGui::Text("Press a key...");
+        // Display the visible bindings in this section
+        ImGuiListClipper clipper;
+        clipper.Begin((int)section.commands.size());
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                renderControlRow(section.commands[row]);
             }
         }
     }
 
+    // The popup lives outside the clipped rows so it stays open while they scroll
+    if (openActionsEditor) {
+        ImGui::OpenPopup("Edit Actions");
+        openActionsEditor = false;
+    }
+    if (ImGui::BeginPopup("Edit Actions")) {
+        renderActionsEditor();
+        ImGui::EndPopup();
+    }
+
     if (ImGui::Button("Save")) {
-        saveControls("cfg/controls.cfg");
+        queueControlsSave("cfg/controls.cfg");
     }
 
     ImGui::End();
-}
\ No newline at end of file
+}
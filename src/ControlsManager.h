@@ -2,9 +2,13 @@
 #define CONTROLSMANAGER_H
 
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
 #include <SDL.h>
+#include "ConfigLexer.h"
+#include "StringMap.h"
+
+class ConfigDocument;
 
 // Structure to store control bindings
 struct ControlBinding {
@@ -13,6 +17,7 @@ struct ControlBinding {
     std::string modifiers; // Modifiers (e.g., "+", "*", "-")
     std::vector<std::string> actions; // Actions bound to the key
     std::string uiName;
+    std::string file = {}; // Config file the key was last bound in, or empty
 };
 
 // Structure to store a section of controls
@@ -22,15 +27,29 @@ struct ControlSection {
 };
 
 // Global map to store control bindings
-extern std::map<std::string, ControlBinding> controls;
+extern StringMap<ControlBinding> controls;
 
 // List of sections to preserve order and headings
 extern std::vector<ControlSection> controlSections;
 
 // Function declarations
 bool loadControls(const std::string& filename);
+bool applyControlLine(const ConfigLine& line, const std::string& file);
+size_t mergeControlChanges(const std::string& filename, const ConfigDocument& before, const ConfigDocument& after);
 bool saveControls(const std::string& filename);
+void queueControlsSave(const std::string& filename);
+std::string serializeControls();
+std::string serializeBinds();
+void canonicalSignature(std::string_view actions, std::string& out);
+// Returns false if the command is unknown or another control already has the actions
+bool setControlActions(const std::string& command, const std::vector<std::string>& actions);
+bool setControlActions(const std::string& command, std::string_view actions); // "a;b;c"
+bool setControlKey(const std::string& command, std::string_view token);
 void renderControlsEditor();
 void processKeybindingEvents(const SDL_Event& event);
+bool isCapturingKey();
+
+// Rebuild the names the actions editor completes, e.g. after new aliases were loaded
+void invalidateActionNames();
 
 #endif // CONTROLSMANAGER_H
\ No newline at end of file
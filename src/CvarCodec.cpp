@@ -0,0 +1,102 @@
+#include "CvarCodec.h"
+#include <charconv>
+#include <cmath>
+#include <system_error>
+
+#ifndef __cpp_lib_to_chars
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#endif
+
+// Parse all of text as a number; from_chars does not take the "+" that stoi did
+template <typename T, typename... Base>
+static bool parseNumber(std::string_view text, T& number, Base... base) {
+    if (!text.empty() && text[0] == '+') {
+        text.remove_prefix(1);
+    }
+    const char* end = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), end, number, base...);
+    return result.ec == std::errc() && result.ptr == end && !text.empty();
+}
+
+#ifdef __cpp_lib_to_chars
+static bool parseFloat(std::string_view text, float& number) {
+    return parseNumber(text, number);
+}
+#else
+// Standard libraries without floating-point from_chars/to_chars: streams in the "C" locale
+static bool parseFloat(std::string_view text, float& number) {
+    std::istringstream in{std::string(text)};
+    in.imbue(std::locale::classic());
+    in >> number;
+    return !in.fail() && in.peek() == std::char_traits<char>::eof();
+}
+#endif
+
+bool parseCvarValue(CvarType type, std::string_view text, CvarValue& value) {
+    switch (type) {
+    case CvarType::Bool:
+        if (text != "0" && text != "1") {
+            return false;
+        }
+        value.boolValue = (text == "1");
+        return true;
+    case CvarType::Int: {
+        int32_t parsed = 0;
+        if (!parseNumber(text, parsed)) return false;
+        value.intValue = parsed;
+        return true;
+    }
+    case CvarType::Float: {
+        float parsed = 0.0f;
+        if (!parseFloat(text, parsed) || !std::isfinite(parsed)) return false;
+        value.floatValue = parsed;
+        return true;
+    }
+    case CvarType::Color: {
+        uint32_t parsed = 0;
+        if (text.size() > 8 || text.find_first_of("+-") != std::string_view::npos || !parseNumber(text, parsed, 16)) {
+            return false;
+        }
+        value.colorValue = parsed;
+        return true;
+    }
+    }
+    return false;
+}
+
+size_t formatCvarValue(CvarType type, CvarValue value, char* buffer) {
+    switch (type) {
+    case CvarType::Bool:
+        buffer[0] = value.boolValue ? '1' : '0';
+        return 1;
+    case CvarType::Int:
+        return std::to_chars(buffer, buffer + cvarValueMaxChars, value.intValue).ptr - buffer;
+    case CvarType::Float: {
+#ifdef __cpp_lib_to_chars
+        // Shortest digits that read back as the same float, never in exponent form
+        return std::to_chars(buffer, buffer + cvarValueMaxChars, value.floatValue, std::chars_format::fixed).ptr - buffer;
+#else
+        std::ostringstream out;
+        out.imbue(std::locale::classic());
+        out << std::setprecision(9) << value.floatValue;
+        const std::string text = out.str();
+        return text.copy(buffer, cvarValueMaxChars);
+#endif
+    }
+    case CvarType::Color: {
+        static const char digits[] = "0123456789ABCDEF";
+        for (int i = 0; i < 8; ++i) {
+            buffer[i] = digits[(value.colorValue >> (28 - 4 * i)) & 0xF];
+        }
+        return 8;
+    }
+    }
+    return 0;
+}
+
+std::string formatCvarValue(const Cvar& cvar) {
+    char buffer[cvarValueMaxChars];
+    return std::string(buffer, formatCvarValue(cvar.type, cvar.value, buffer));
+}
@@ -0,0 +1,28 @@
+#ifndef CVARCODEC_H
+#define CVARCODEC_H
+
+#include "CvarManager.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Text form of cvar values in .cfg files, built on std::from_chars/std::to_chars: no
+// exceptions, no locale, no allocation.
+//   bool   "0" or "1"
+//   int    decimal, optionally signed
+//   float  decimal; written in the shortest form that reads back as the same float
+//   color  RRGGBBAA in hex; written as 8 upper-case digits
+
+// Longest text formatCvarValue writes
+const size_t cvarValueMaxChars = 64;
+
+// Parse the text of a value. Returns false, leaving value untouched, when the text is not
+// a complete value of the type.
+bool parseCvarValue(CvarType type, std::string_view text, CvarValue& value);
+
+// Write a value to buffer, which must hold cvarValueMaxChars characters. Returns the length.
+size_t formatCvarValue(CvarType type, CvarValue value, char* buffer);
+
+std::string formatCvarValue(const Cvar& cvar);
+
+#endif // CVARCODEC_H
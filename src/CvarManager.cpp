@@ -1,91 +1,231 @@
 #include "CvarManager.h"
-#include <fstream>
+#include "CvarCodec.h"
+#include "CvarSchema.h"
+#include "SchemaCache.h"
+#include "CvarSchemaFile.h"
+#include "AsyncSaver.h"
+#include "ConfigLexer.h"
+#include "ConfigDocument.h"
+#include "EditHistory.h"
+#include "ExecGraph.h"
+#include "ConfigArena.h"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <cstdio>
 #include "imgui.h"
 
-using json = nlohmann::json;
+// Memory of the cvar map: a pool over a counted heap. Declared before the map, so they
+// outlive it.
+static CountingResource cvarHeap;
+static std::pmr::unsynchronized_pool_resource cvarPool(&cvarHeap);
 
 // Global map to store cvars
-std::map<std::string, Cvar> cvars;
+StringMap<Cvar> cvars(&cvarPool);
+
+// Cvars ordered by name, as they are saved. Rebuilt only when the set of cvars changes.
+static std::vector<StringMap<Cvar>::value_type*> cvarsByName;
+static bool cvarsByNameValid = false;
+
+static const std::vector<StringMap<Cvar>::value_type*>& orderedCvars() {
+    if (!cvarsByNameValid) {
+        cvarsByName = cvars.sorted();
+        cvarsByNameValid = true;
+    }
+    return cvarsByName;
+}
+
+size_t cvarMemoryInUse() {
+    return cvarHeap.bytesInUse();
+}
+
+size_t cvarMemoryHighWaterMark() {
+    return cvarHeap.highWaterMark();
+}
+
+const char* cvarTypeName(CvarType type) {
+    switch (type) {
+    case CvarType::Bool: return "bool";
+    case CvarType::Int: return "int";
+    case CvarType::Float: return "float";
+    case CvarType::Color: return "color";
+    }
+    return "";
+}
+
+bool parseCvarType(std::string_view name, CvarType& type) {
+    if (name == "bool") {
+        type = CvarType::Bool;
+    } else if (name == "int") {
+        type = CvarType::Int;
+    } else if (name == "float") {
+        type = CvarType::Float;
+    } else if (name == "color") {
+        type = CvarType::Color;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Pack RGBA floats in [0, 1] into 0xRRGGBBAA
+uint32_t packColor(const float rgba[4]) {
+    uint32_t color = 0;
+    for (int i = 0; i < 4; ++i) {
+        float channel = std::clamp(rgba[i], 0.0f, 1.0f);
+        color = (color << 8) | static_cast<uint32_t>(channel * 255.0f + 0.5f);
+    }
+    return color;
+}
+
+// Unpack 0xRRGGBBAA into RGBA floats in [0, 1]
+void unpackColor(uint32_t color, float rgba[4]) {
+    rgba[0] = ((color >> 24) & 0xFF) / 255.0f; // Red
+    rgba[1] = ((color >> 16) & 0xFF) / 255.0f; // Green
+    rgba[2] = ((color >> 8) & 0xFF) / 255.0f;  // Blue
+    rgba[3] = (color & 0xFF) / 255.0f;         // Alpha
+}
+
+// Whether a value lies within the cvar's [min, max]. Bools and colors have no range.
+bool cvarValueInRange(const Cvar& cvar, CvarValue value) {
+    switch (cvar.type) {
+    case CvarType::Int: return value.intValue >= cvar.minValue.intValue && value.intValue <= cvar.maxValue.intValue;
+    case CvarType::Float: return value.floatValue >= cvar.minValue.floatValue && value.floatValue <= cvar.maxValue.floatValue;
+    default: return true;
+    }
+}
+
+static bool sameCvarValue(CvarType type, CvarValue a, CvarValue b) {
+    switch (type) {
+    case CvarType::Bool: return a.boolValue == b.boolValue;
+    case CvarType::Int: return a.intValue == b.intValue;
+    case CvarType::Float: return a.floatValue == b.floatValue;
+    case CvarType::Color: return a.colorValue == b.colorValue;
+    }
+    return false;
+}
+
+// Config files cvar values were read from; Cvar::source is an index into it plus one
+static std::vector<std::string> cvarSourceFiles;
+
+// Source index of a file, adding it on first use
+static uint16_t cvarSourceIndex(const std::string& file) {
+    if (file.empty()) {
+        return 0;
+    }
+    // Lines come file by file, so the newest entry is the likely match
+    for (size_t i = cvarSourceFiles.size(); i-- > 0;) {
+        if (cvarSourceFiles[i] == file) {
+            return (uint16_t)(i + 1);
+        }
+    }
+    if (cvarSourceFiles.size() == UINT16_MAX) {
+        return 0; // Untracked; saved to the default file
+    }
+    cvarSourceFiles.push_back(file);
+    return (uint16_t)cvarSourceFiles.size();
+}
+
+// File that last set a cvar, or nullptr if its value did not come from a file
+const std::string* cvarSourceFile(const Cvar& cvar) {
+    return cvar.source != 0 ? &cvarSourceFiles[cvar.source - 1] : nullptr;
+}
+
+// Apply a "name value" line from file if it sets a known cvar
+bool applyCvarLine(const ConfigLine& line, const std::string& file) {
+    if (line.kind != ConfigLineKind::Command || line.key.empty()) {
+        return false; // Skip invalid lines
+    }
+
+    auto it = cvars.find(line.command);
+    if (it == cvars.end()) {
+        return false;
+    }
+    if (parseCvarValue(it->second.type, line.key, it->second.value)) {
+        it->second.source = cvarSourceIndex(file);
+    }
+    return true;
+}
 
 // Function to load cvars from a .cfg file
 void loadCvarsFromConfig(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    ConfigDocument& document = editorDocument(filename);
+    if (!document.load(filename)) {
         std::cerr << "Failed to open " << filename << " for reading. Using default values." << std::endl;
         return;
     }
+    clearEditHistory(); // Undo must not bring back values from before the load
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        std::string value;
-        if (!(iss >> key >> value)) {
-            continue; // Skip invalid lines
-        }
+    for (const ConfigLine& line : document.lines()) {
+        applyCvarLine(line, filename);
+    }
 
-        auto it = cvars.find(key);
-        if (it != cvars.end()) {
-            Cvar& cvar = it->second;
-            if (cvar.type == "bool") {
-                cvar.boolValue = (value == "1");
-            } else if (cvar.type == "int") {
-                cvar.intValue = std::stoi(value);
-            } else if (cvar.type == "float") {
-                cvar.floatValue = std::stof(value);
-            } else if (cvar.type == "color") {
-                unsigned int color = std::stoul(value, nullptr, 16);
-                cvar.colorValue[0] = ((color >> 24) & 0xFF) / 255.0f; // Red
-                cvar.colorValue[1] = ((color >> 16) & 0xFF) / 255.0f; // Green
-                cvar.colorValue[2] = ((color >> 8) & 0xFF) / 255.0f;  // Blue
-                cvar.colorValue[3] = (color & 0xFF) / 255.0f;         // Alpha
+    std::cout << "Configuration loaded from " << filename << std::endl;
+}
+
+// Add or replace a cvar from a schema entry
+static void applyCvarSchemaEntry(const CvarSchemaEntry& entry) {
+    Cvar& cvar = cvars.emplace(entry.name).first->second;
+    cvar.type = entry.type;
+    cvar.source = 0;
+    cvar.value = entry.defaultValue;
+    cvar.defaultValue = entry.defaultValue;
+    cvar.minValue = entry.minValue;
+    cvar.maxValue = entry.maxValue;
+}
+
+// Apply cvar definitions from a JSON schema file on top of the compiled-in schema
+static bool loadCvarSchemaOverride(const std::string& jsonFilename) {
+    {
+        // Use the binary image of the schema while it is up to date
+        SchemaCache cache;
+        if (cache.open(jsonFilename)) {
+            for (size_t i = 0; i < cache.size(); ++i) {
+                applyCvarSchemaEntry(cache.entry(i));
             }
+            return true;
         }
     }
 
-    file.close();
-    std::cout << "Configuration loaded from " << filename << std::endl;
+    // Every entry is parsed: the editor lists them all and the cache image needs them
+    CvarSchemaFile schema;
+    if (!schema.open(jsonFilename)) {
+        return false;
+    }
+    for (const CvarSchemaEntry& entry : schema.entries()) {
+        applyCvarSchemaEntry(entry);
+    }
+
+    // The schema file stays mapped until here, so the entry names are still valid. Without
+    // a cache directory the schema is simply parsed every time.
+    if (!SchemaCache::path(jsonFilename).empty() && !SchemaCache::write(jsonFilename, schema.entries())) {
+        std::cerr << "Failed to write schema cache for " << jsonFilename << std::endl;
+    }
+    return true;
 }
 
-// Function to load cvars from JSON and config files
-bool loadCvars(const std::string& jsonFilename, const std::string& configFilename) {
-    // Load min/max and default values from JSON
-    std::ifstream jsonFile(jsonFilename);
-    if (!jsonFile.is_open()) {
-        std::cerr << "Failed to open " << jsonFilename << std::endl;
-        return false;
+// Function to load the cvar schema: compiled-in defaults, optionally overridden by a JSON file
+bool loadCvarSchema(const std::string& jsonFilename) {
+    clearEditHistory(); // Its edits are of values the schema resets
+
+    // Start from the schema compiled in at build time
+    for (const CvarSchemaEntry& entry : builtinCvarSchema()) {
+        applyCvarSchemaEntry(entry);
     }
 
-    json j;
-    jsonFile >> j;
-
-    for (auto& [key, value] : j.items()) {
-        Cvar cvar;
-        cvar.name = key;
-        cvar.type = value["type"];
-        if (cvar.type == "bool") {
-            cvar.boolValue = value["default"];
-        } else if (cvar.type == "int") {
-            cvar.intValue = value["default"];
-            cvar.minValue = value["min"];
-            cvar.maxValue = value["max"];
-        } else if (cvar.type == "float") {
-            cvar.floatValue = value["default"];
-            cvar.minValue = value["min"];
-            cvar.maxValue = value["max"];
-        } else if (cvar.type == "color") {
-            std::string colorHex = value["default"];
-            if (colorHex[0] == '#') colorHex = colorHex.substr(1); // Remove '#'
-            unsigned int color = std::stoul(colorHex, nullptr, 16);
-            cvar.colorValue[0] = ((color >> 24) & 0xFF) / 255.0f; // Red
-            cvar.colorValue[1] = ((color >> 16) & 0xFF) / 255.0f; // Green
-            cvar.colorValue[2] = ((color >> 8) & 0xFF) / 255.0f;  // Blue
-            cvar.colorValue[3] = (color & 0xFF) / 255.0f;         // Alpha
-        }
-        cvars[key] = cvar;
+    // A schema file next to the executable overrides min/max and default values
+    if (loadCvarSchemaOverride(jsonFilename)) {
+        std::cout << "Cvar schema overridden by " << jsonFilename << std::endl;
+    }
+
+    invalidateCvarView();
+    return true;
+}
+
+// Function to load cvars from the schema and config files
+bool loadCvars(const std::string& jsonFilename, const std::string& configFilename) {
+    if (!loadCvarSchema(jsonFilename)) {
+        return false;
     }
 
     // Load actual values from config file
@@ -94,75 +234,300 @@ bool loadCvars(const std::string& jsonFilename, const std::string& configFilenam
     return true;
 }
 
+// Value token of the last assignment of each cvar in a document
+static std::map<Cvar*, std::string_view> lastCvarTokens(const ConfigDocument& document) {
+    std::map<Cvar*, std::string_view> tokens;
+    for (const ConfigLine& line : document.lines()) {
+        if (line.kind != ConfigLineKind::Command || line.key.empty()) {
+            continue;
+        }
+        auto it = cvars.find(line.command);
+        if (it != cvars.end()) {
+            tokens[&it->second] = line.key;
+        }
+    }
+    return tokens;
+}
+
+// Apply what changed between two versions of a config file to the cvars. A cvar that was
+// changed in the editor since the file was last read keeps the editor's value, one set by
+// a file executed later keeps that file's value, and cvars whose lines were removed keep
+// their current value. Returns the number of cvars changed.
+size_t mergeCvarChanges(const std::string& filename, const ConfigDocument& before, const ConfigDocument& after) {
+    std::map<Cvar*, std::string_view> oldTokens = lastCvarTokens(before);
+    size_t changes = 0;
+    for (const auto& [cvar, token] : lastCvarTokens(after)) {
+        const std::string* source = cvarSourceFile(*cvar);
+        if (source && execsAfter(*source, filename)) {
+            continue; // The later file's value is the one the game ends up with
+        }
+
+        CvarValue newValue = cvar->value;
+        if (!parseCvarValue(cvar->type, token, newValue)) {
+            continue;
+        }
+
+        auto old = oldTokens.find(cvar);
+        if (old != oldTokens.end()) {
+            CvarValue oldValue = cvar->value;
+            parseCvarValue(cvar->type, old->second, oldValue);
+            if (sameCvarValue(cvar->type, oldValue, newValue) || !sameCvarValue(cvar->type, cvar->value, oldValue)) {
+                continue; // Unchanged on disk, or edited here since
+            }
+        }
+
+        if (!sameCvarValue(cvar->type, cvar->value, newValue)) {
+            cvar->value = newValue;
+            cvar->source = cvarSourceIndex(filename);
+            ++changes;
+        }
+    }
+    return changes;
+}
+
+// Append a "name value" line with the value aligned to column 20
+static void appendCvarLine(std::string& out, std::string_view key, const Cvar& cvar) {
+    char value[cvarValueMaxChars];
+    out += key;
+    out.append(key.size() < 20 ? 20 - key.size() : 1, ' ');
+    out.append(value, formatCvarValue(cvar.type, cvar.value, value));
+    out += '\n';
+}
+
+// Render every cvar in .cfg format
+std::string serializeCvars() {
+    std::string file;
+    for (const auto* entry : orderedCvars()) {
+        appendCvarLine(file, entry->first, entry->second);
+    }
+    return file;
+}
+
+// Build the content of one file from the cvars it owns. An existing file keeps its text
+// and only the values that changed are rewritten; owned cvars it does not mention are
+// appended when they differ from their default. A new file gets every owned cvar.
+// Returns false when the file would not change and no save of it is queued; a queued save
+// is always replaced, even by the text on disk when an edit was undone.
+static bool prepareCvarFile(const std::string& filename, const std::vector<const StringMap<Cvar>::value_type*>& owned,
+                            std::string& content) {
+    ConfigDocument* queued = queuedSaveDocument(filename);
+    ConfigDocument& document = queued ? *queued : editorDocument(filename);
+    if (!document.isLoaded() && !document.load(filename)) {
+        for (const auto* entry : owned) {
+            appendCvarLine(content, entry->first, entry->second);
+        }
+        return true;
+    }
+
+    // The last assignment of a cvar is the one the game ends up with
+    std::map<const Cvar*, const ConfigLine*> lastAssignment;
+    for (const ConfigLine& line : document.lines()) {
+        if (line.kind != ConfigLineKind::Command || line.key.empty()) {
+            continue;
+        }
+        auto it = cvars.find(line.command);
+        if (it != cvars.end()) {
+            lastAssignment[&it->second] = &line;
+        }
+    }
+
+    std::vector<ConfigEdit> edits;
+    std::string appended;
+    for (const auto* entry : owned) {
+        const auto& [key, cvar] = *entry;
+        auto assigned = lastAssignment.find(&cvar);
+        if (assigned == lastAssignment.end()) {
+            if (!sameCvarValue(cvar.type, cvar.value, cvar.defaultValue)) {
+                appendCvarLine(appended, key, cvar);
+            }
+            continue;
+        }
+
+        // Keep the original spelling of values that did not change (e.g. "144.5")
+        std::string_view token = assigned->second->key;
+        CvarValue fileValue = cvar.value;
+        parseCvarValue(cvar.type, token, fileValue);
+        if (!sameCvarValue(cvar.type, cvar.value, fileValue)) {
+            edits.push_back({document.offsetOf(token), token.size(), formatCvarValue(cvar)});
+        }
+    }
+
+    if (edits.empty() && appended.empty() && !queued) {
+        return false;
+    }
+    content = document.applyEdits(std::move(edits), appended);
+    return true;
+}
+
+// Later saves patch what was written. Only called once the file is on disk, so a failed
+// write leaves the document at what the file still has.
+static void cvarFileSaved(const std::string& filename, const std::string& content) {
+    editorDocument(filename).assign(filename, content);
+}
+
+// Build the files to write for a save to filename. A cvar is written back to the file
+// that set it last, which the game also runs last, so an edit is not overridden by a
+// later exec; cvars no file has set go to filename.
+static std::vector<ConfigSave> prepareCvarsSave(const std::string& filename) {
+    std::map<std::string_view, std::vector<const StringMap<Cvar>::value_type*>> owned;
+    for (const auto* entry : orderedCvars()) {
+        const std::string* source = cvarSourceFile(entry->second);
+        owned[source ? std::string_view(*source) : std::string_view(filename)].push_back(entry);
+    }
+
+    std::vector<ConfigSave> saves;
+    for (const auto& [file, entries] : owned) {
+        ConfigSave save{std::string(file), std::string()};
+        if (prepareCvarFile(save.path, entries, save.content)) {
+            saves.push_back(std::move(save));
+        }
+    }
+    return saves;
+}
+
 // Function to save cvars to a .cfg file
 void saveCvarsToFile(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open " << filename << " for writing." << std::endl;
+    std::vector<ConfigSave> saves = prepareCvarsSave(filename);
+    if (saves.empty()) {
+        std::cout << "No changes to save to " << filename << std::endl;
         return;
     }
+    for (const ConfigSave& save : saves) {
+        if (writeFileAtomically(save.path, save.content)) {
+            cvarFileSaved(save.path, save.content);
+            std::cout << "Configuration saved to " << save.path << std::endl;
+        }
+    }
+}
 
-    for (const auto& [key, cvar] : cvars) {
-        file << std::left << std::setw(20) << key; // Align the key to 20 characters
-        if (cvar.type == "bool") {
-            file << (cvar.boolValue ? "1" : "0");
-        } else if (cvar.type == "int") {
-            file << cvar.intValue;
-        } else if (cvar.type == "float") {
-            file << std::fixed << std::setprecision(3) << cvar.floatValue; // Save float with 3 decimal places
-        } else if (cvar.type == "color") {
-            unsigned int color = 
-                ((unsigned int)(cvar.colorValue[0] * 255) << 24) | // Red
-                ((unsigned int)(cvar.colorValue[1] * 255) << 16) | // Green
-                ((unsigned int)(cvar.colorValue[2] * 255) << 8)  | // Blue
-                ((unsigned int)(cvar.colorValue[3] * 255));        // Alpha
-            file << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << color;
+// Save a snapshot of the cvars on the background writer
+void queueCvarsSave(const std::string& filename) {
+    for (ConfigSave& save : prepareCvarsSave(filename)) {
+        std::string path = save.path;
+        queueSave(save.path, std::move(save.content), [path](const std::string& content) { cvarFileSaved(path, content); });
+    }
+}
 
-            // Reset stream manipulators after writing hex
-            file << std::dec << std::setfill(' ') << std::setw(0);
+// Unpacked color of the color cvar currently being edited
+static const Cvar* activeColorCvar = nullptr;
+static float activeColor[4];
+
+// Cvars grouped by type, then by name. Rebuilt only when the set of cvars changes.
+static std::vector<StringMap<Cvar>::value_type*> sortedCvars;
+static bool sortedCvarsValid = false;
+
+// Range of sortedCvars sharing one type
+struct CvarGroup {
+    CvarType type;
+    int begin;
+    int end;
+};
+static std::vector<CvarGroup> cvarGroups;
+
+void invalidateCvarView() {
+    cvarsByNameValid = false;
+    sortedCvarsValid = false;
+}
+
+static void rebuildCvarView() {
+    sortedCvars = orderedCvars();
+
+    // The view is ordered by name, so a stable sort by type keeps names in order within a type
+    std::stable_sort(sortedCvars.begin(), sortedCvars.end(), [](const StringMap<Cvar>::value_type* a, const StringMap<Cvar>::value_type* b) {
+        return a->second.type < b->second.type; // Compare the type tags
+    });
+
+    cvarGroups.clear();
+    for (int i = 0; i < (int)sortedCvars.size(); ++i) {
+        CvarType type = sortedCvars[i]->second.type;
+        if (cvarGroups.empty() || cvarGroups.back().type != type) {
+            cvarGroups.push_back({type, i, i});
         }
-        file << std::endl;
+        cvarGroups.back().end = i + 1;
     }
+    sortedCvarsValid = true;
+}
 
-    file.close();
-    std::cout << "Configuration saved to " << filename << std::endl;
+// Render the editor widget and label of one cvar
+static void renderCvarRow(const std::pmr::string& key, Cvar& cvar) {
+    ImGui::PushID(key.c_str()); // Use the cvar name as a unique ID
+
+    CvarValue before = cvar.value;
+    bool edited = false;
+    switch (cvar.type) {
+    case CvarType::Bool:
+        edited = ImGui::Checkbox("##bool", &cvar.value.boolValue); // Render the control
+        break;
+    case CvarType::Int:
+        edited = ImGui::SliderInt("##int", &cvar.value.intValue, cvar.minValue.intValue, cvar.maxValue.intValue);
+        break;
+    case CvarType::Float:
+        edited = ImGui::SliderFloat("##float", &cvar.value.floatValue, cvar.minValue.floatValue, cvar.maxValue.floatValue);
+        break;
+    case CvarType::Color: {
+        // Colors are kept packed; the float copy only lives while the widget is being edited
+        float rgba[4];
+        float* color = rgba;
+        if (activeColorCvar == &cvar) {
+            color = activeColor;
+        } else {
+            unpackColor(cvar.value.colorValue, rgba);
+        }
+        if (ImGui::ColorEdit4("##color", color)) {
+            cvar.value.colorValue = packColor(color);
+            edited = true;
+        }
+        if (ImGui::IsItemActive()) {
+            if (activeColorCvar != &cvar) {
+                std::copy(color, color + 4, activeColor);
+                activeColorCvar = &cvar;
+            }
+        } else if (activeColorCvar == &cvar) {
+            activeColorCvar = nullptr;
+        }
+        break;
+    }
+    }
+
+    // One history entry per drag: edits merge until the widget is released
+    if (edited) {
+        recordCvarEdit(cvar, before);
+    }
+    if (ImGui::IsItemDeactivated()) {
+        endEditGroup();
+    }
+
+    ImGui::SameLine(); // Place the label on the same line as the control
+    ImGui::Text("%s", key.c_str()); // Render the label
+
+    ImGui::PopID(); // Restore the previous ID
 }
 
 // Function to render the cvars GUI
 void renderCvars() {
-    // Create a vector of cvars sorted by type
-    std::vector<std::pair<std::string, Cvar*>> sortedCvars;
-    for (auto& [key, cvar] : cvars) {
-        sortedCvars.emplace_back(key, &cvar);
+    if (!sortedCvarsValid) {
+        rebuildCvarView();
     }
 
-    // Sort the cvars by type (alphabetically)
-    std::sort(sortedCvars.begin(), sortedCvars.end(), [](const std::pair<std::string, Cvar*>& a, const std::pair<std::string, Cvar*>& b) {
-        return a.second->type < b.second->type; // Compare the type strings
-    });
-
-    // Render the sorted cvars
-    for (auto& [key, cvarPtr] : sortedCvars) {
-        Cvar& cvar = *cvarPtr; // Dereference the pointer to access the actual Cvar object
-        ImGui::PushID(key.c_str()); // Use the cvar name as a unique ID
-
-        if (cvar.type == "bool") {
-            ImGui::Checkbox("##bool", &cvar.boolValue); // Render the control
-        } else if (cvar.type == "int") {
-            ImGui::SliderInt("##int", &cvar.intValue, (int)cvar.minValue, (int)cvar.maxValue);
-        } else if (cvar.type == "float") {
-            ImGui::SliderFloat("##float", &cvar.floatValue, cvar.minValue, cvar.maxValue);
-        } else if (cvar.type == "color") {
-            ImGui::ColorEdit4("##color", cvar.colorValue);
+    // Render one collapsible group per type; only the visible rows are submitted
+    for (const CvarGroup& group : cvarGroups) {
+        char header[64];
+        snprintf(header, sizeof(header), "%s (%d)###%s", cvarTypeName(group.type), group.end - group.begin, cvarTypeName(group.type));
+        if (!ImGui::CollapsingHeader(header, ImGuiTreeNodeFlags_DefaultOpen)) {
+            continue;
         }
 
-        ImGui::SameLine(); // Place the label on the same line as the control
-        ImGui::Text("%s", key.c_str()); // Render the label
-
-        ImGui::PopID(); // Restore the previous ID
+        ImGuiListClipper clipper;
+        clipper.Begin(group.end - group.begin);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                auto& [key, cvar] = *sortedCvars[group.begin + row];
+                renderCvarRow(key, cvar);
+            }
+        }
     }
 
     if (ImGui::Button("Save")) {
-        saveCvarsToFile("cfg/cvars.cfg");
+        queueCvarsSave("cfg/cvars.cfg");
     }
 }
@@ -2,28 +2,67 @@
 #define CVARMANAGER_H
 
 #include <string>
-#include <map>
-#include <nlohmann/json.hpp>
+#include "StringMap.h"
+#include <cstdint>
+#include <string_view>
+#include "ConfigLexer.h"
+
+class ConfigDocument;
+
+// Type tag of a cvar
+enum class CvarType : uint8_t {
+    Bool,
+    Int,
+    Float,
+    Color
+};
+
+// Cvar payload; the active member is selected by the cvar's type
+union CvarValue {
+    int32_t intValue;
+    bool boolValue;
+    float floatValue;
+    uint32_t colorValue; // Packed RGBA8 (0xRRGGBBAA)
+
+    constexpr CvarValue() : intValue(0) {}
+    explicit constexpr CvarValue(bool value) : boolValue(value) {}
+    explicit constexpr CvarValue(int32_t value) : intValue(value) {}
+    explicit constexpr CvarValue(float value) : floatValue(value) {}
+    explicit constexpr CvarValue(uint32_t value) : colorValue(value) {}
+};
 
 // Structure to hold cvar data
 struct Cvar {
-    std::string type;
-    std::string name;
-    bool boolValue = false;
-    int intValue = 0;
-    float floatValue = 0.0f;
-    float minValue = 0.0f;
-    float maxValue = 0.0f;
-    float colorValue[4] = {0.0f, 0.0f, 0.0f, 0.0f}; // RGBA values for color cvars
+    CvarType type = CvarType::Bool;
+    uint16_t source = 0; // Config file that last set the value (see cvarSourceFile), or 0
+    CvarValue value = {};
+    CvarValue defaultValue = {};
+    CvarValue minValue = {};
+    CvarValue maxValue = {};
 };
 
-// Global map to store cvars
-extern std::map<std::string, Cvar> cvars;
+// Global map to store cvars, in schema order. Its memory comes from a pool, so loading a
+// large schema takes a few big blocks instead of one allocation per cvar.
+extern StringMap<Cvar> cvars;
 
 // Function declarations
 void loadCvarsFromConfig(const std::string& filename);
+bool applyCvarLine(const ConfigLine& line, const std::string& file);
+const std::string* cvarSourceFile(const Cvar& cvar);
+bool loadCvarSchema(const std::string& jsonFilename);
 bool loadCvars(const std::string& jsonFilename, const std::string& configFilename);
+size_t mergeCvarChanges(const std::string& filename, const ConfigDocument& before, const ConfigDocument& after);
 void saveCvarsToFile(const std::string& filename);
+void queueCvarsSave(const std::string& filename);
+std::string serializeCvars();
 void renderCvars();
+void invalidateCvarView();
+bool cvarValueInRange(const Cvar& cvar, CvarValue value);
+size_t cvarMemoryInUse();
+size_t cvarMemoryHighWaterMark();
+const char* cvarTypeName(CvarType type);
+bool parseCvarType(std::string_view name, CvarType& type);
+uint32_t packColor(const float rgba[4]);
+void unpackColor(uint32_t color, float rgba[4]);
 
 #endif // CVARMANAGER_H
\ No newline at end of file
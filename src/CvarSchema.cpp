@@ -0,0 +1,10 @@
+#include "CvarSchema.h"
+#include "CvarSchema.gen.h"
+
+SchemaTable<CvarSchemaEntry> builtinCvarSchema() {
+    return {generatedCvarSchema, sizeof(generatedCvarSchema) / sizeof(generatedCvarSchema[0])};
+}
+
+SchemaTable<CommandSchemaEntry> builtinCommandSchema() {
+    return {generatedCommandSchema, sizeof(generatedCommandSchema) / sizeof(generatedCommandSchema[0])};
+}
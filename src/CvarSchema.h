@@ -0,0 +1,89 @@
+#ifndef CVARSCHEMA_H
+#define CVARSCHEMA_H
+
+#include "CvarManager.h"
+#include <cstddef>
+#include <string_view>
+
+// Schema entry of a cvar: type, default and range
+struct CvarSchemaEntry {
+    std::string_view name;
+    CvarType type;
+    CvarValue defaultValue;
+    CvarValue minValue;
+    CvarValue maxValue;
+};
+
+// Schema entry of an engine command
+struct CommandSchemaEntry {
+    std::string_view name;
+    std::string_view description;
+};
+
+// Read-only view of a compiled-in schema table
+template <typename T>
+struct SchemaTable {
+    const T* entries = nullptr;
+    size_t count = 0;
+
+    const T* begin() const { return entries; }
+    const T* end() const { return entries + count; }
+    size_t size() const { return count; }
+};
+
+// Schema compiled in from assets/cvars.json and assets/ccmds.json at build time
+SchemaTable<CvarSchemaEntry> builtinCvarSchema();
+SchemaTable<CommandSchemaEntry> builtinCommandSchema();
+
+// Parse "#RRGGBBAA" (or without '#') at compile time. Invalid input is not a constant expression.
+constexpr uint32_t parseSchemaColor(std::string_view hex) {
+    if (!hex.empty() && hex[0] == '#') {
+        hex.remove_prefix(1);
+    }
+    if (hex.empty() || hex.size() > 8) {
+        throw "invalid color";
+    }
+    uint32_t color = 0;
+    for (char c : hex) {
+        uint32_t digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            throw "invalid color";
+        }
+        color = (color << 4) | digit;
+    }
+    return color;
+}
+
+// Check that defaults lie within their range and that names are unique
+template <size_t N>
+constexpr bool validateCvarSchema(const CvarSchemaEntry (&schema)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        const CvarSchemaEntry& entry = schema[i];
+        if (entry.type == CvarType::Int &&
+            (entry.minValue.intValue > entry.maxValue.intValue ||
+             entry.defaultValue.intValue < entry.minValue.intValue ||
+             entry.defaultValue.intValue > entry.maxValue.intValue)) {
+            return false;
+        }
+        if (entry.type == CvarType::Float &&
+            (entry.minValue.floatValue > entry.maxValue.floatValue ||
+             entry.defaultValue.floatValue < entry.minValue.floatValue ||
+             entry.defaultValue.floatValue > entry.maxValue.floatValue)) {
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (schema[j].name == entry.name) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif // CVARSCHEMA_H
@@ -0,0 +1,315 @@
+#include "CvarSchemaFile.h"
+#include "CvarCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+static bool isJsonSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void skipSpace(std::string_view text, size_t& position) {
+    while (position < text.size() && isJsonSpace(text[position])) {
+        ++position;
+    }
+}
+
+// Skip a string starting at its opening quote. Returns false if it is not closed.
+static bool skipString(std::string_view text, size_t& position, bool& escaped) {
+    escaped = false;
+    for (++position; position < text.size(); ++position) {
+        if (text[position] == '\\') {
+            escaped = true;
+            ++position;
+        } else if (text[position] == '"') {
+            ++position;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Skip one value without parsing it: strings and nesting are followed, anything else runs
+// to the next delimiter. Checking what is inside is left to the SAX parser.
+static bool skipValue(std::string_view text, size_t& position) {
+    bool escaped = false;
+    int depth = 0;
+    while (position < text.size()) {
+        char c = text[position];
+        if (c == '"') {
+            if (!skipString(text, position, escaped)) {
+                return false;
+            }
+        } else if (c == '{' || c == '[') {
+            ++depth;
+            ++position;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                return true; // End of the enclosing object
+            }
+            --depth;
+            ++position;
+        } else if (depth == 0 && (c == ',' || isJsonSpace(c))) {
+            return true;
+        } else {
+            ++position;
+            continue;
+        }
+        if (depth == 0) {
+            return true; // A whole string, object or array
+        }
+    }
+    return depth == 0;
+}
+
+bool CvarSchemaFile::fail(size_t offset, const char* message) const {
+    std::cerr << path << ": byte " << offset << ": " << message << std::endl;
+    return false;
+}
+
+bool CvarSchemaFile::open(const std::string& filename) {
+    path = filename;
+    records.clear();
+    unescapedNames.clear();
+    if (!file.open(filename)) {
+        return false;
+    }
+
+    const std::string_view text = file.view();
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        return fail(0, "schema file too large");
+    }
+
+    size_t position = 0;
+    skipSpace(text, position);
+    if (position >= text.size() || text[position] != '{') {
+        return fail(position, "expected a JSON object");
+    }
+    ++position;
+    skipSpace(text, position);
+    if (position < text.size() && text[position] == '}') {
+        return true; // Empty schema
+    }
+
+    while (true) {
+        // "name"
+        if (position >= text.size() || text[position] != '"') {
+            return fail(position, "expected a cvar name");
+        }
+        size_t nameBegin = position;
+        bool escaped = false;
+        if (!skipString(text, position, escaped)) {
+            return fail(nameBegin, "unterminated string");
+        }
+        Span span;
+        span.name = text.substr(nameBegin + 1, position - nameBegin - 2);
+        if (escaped) {
+            json name = json::parse(text.substr(nameBegin, position - nameBegin), nullptr, false);
+            if (!name.is_string()) {
+                return fail(nameBegin, "invalid cvar name");
+            }
+            span.name = unescapedNames.emplace_back(name.get<std::string>());
+        }
+
+        // : value
+        skipSpace(text, position);
+        if (position >= text.size() || text[position] != ':') {
+            return fail(position, "expected ':'");
+        }
+        ++position;
+        skipSpace(text, position);
+        span.begin = (uint32_t)position;
+        if (!skipValue(text, position)) {
+            return fail(span.begin, "unterminated value");
+        }
+        span.end = (uint32_t)position;
+
+        CvarSchemaEntry record;
+        if (parseEntry(span, record)) {
+            records.push_back(record);
+        }
+
+        // , or }
+        skipSpace(text, position);
+        if (position < text.size() && text[position] == ',') {
+            ++position;
+            skipSpace(text, position);
+            continue;
+        }
+        if (position < text.size() && text[position] == '}') {
+            break;
+        }
+        return fail(position, "expected ',' or '}'");
+    }
+    return true;
+}
+
+// One scalar field of an entry as it appeared in the file
+struct SchemaField {
+    enum Kind : uint8_t { Missing, Boolean, Integer, Number, String, Other } kind = Missing;
+    bool boolean = false;
+    int64_t integer = 0;
+    double number = 0.0;
+    std::string string;
+};
+
+// SAX handler collecting the fields of one entry object; other keys and nested values
+// are skipped
+class SchemaEntrySax : public nlohmann::json_sax<json> {
+public:
+    SchemaField type, defaultValue, minValue, maxValue;
+    bool isObject = false; // Whether the entry's value is an object at all
+    size_t errorPosition = 0;
+    std::string errorToken;
+
+    bool null() override { return set(SchemaField::Other); }
+    bool boolean(bool value) override {
+        if (SchemaField* f = current()) {
+            f->kind = SchemaField::Boolean;
+            f->boolean = value;
+        }
+        return true;
+    }
+    bool number_integer(number_integer_t value) override {
+        if (SchemaField* f = current()) {
+            f->kind = SchemaField::Integer;
+            f->integer = value;
+            f->number = (double)value;
+        }
+        return true;
+    }
+    bool number_unsigned(number_unsigned_t value) override {
+        if (SchemaField* f = current()) {
+            f->kind = value <= (number_unsigned_t)std::numeric_limits<int64_t>::max() ? SchemaField::Integer : SchemaField::Number;
+            f->integer = (int64_t)std::min<number_unsigned_t>(value, std::numeric_limits<int64_t>::max());
+            f->number = (double)value;
+        }
+        return true;
+    }
+    bool number_float(number_float_t value, const string_t&) override {
+        if (SchemaField* f = current()) {
+            f->kind = SchemaField::Number;
+            f->number = value;
+        }
+        return true;
+    }
+    bool string(string_t& value) override {
+        if (SchemaField* f = current()) {
+            f->kind = SchemaField::String;
+            f->string = std::move(value);
+        }
+        return true;
+    }
+    bool binary(binary_t&) override { return set(SchemaField::Other); }
+    bool start_object(std::size_t) override {
+        if (depth == 0) {
+            isObject = true;
+        } else {
+            set(SchemaField::Other);
+        }
+        ++depth;
+        return true;
+    }
+    bool end_object() override {
+        --depth;
+        return true;
+    }
+    bool start_array(std::size_t) override {
+        set(SchemaField::Other);
+        ++depth;
+        return true;
+    }
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+    bool key(string_t& name) override {
+        if (depth == 1) {
+            field = name == "type" ? &type : name == "default" ? &defaultValue : name == "min" ? &minValue : name == "max" ? &maxValue : nullptr;
+        }
+        return true;
+    }
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception&) override {
+        errorPosition = position;
+        errorToken = lastToken;
+        return false;
+    }
+
+private:
+    // Field the next value at depth 1 belongs to
+    SchemaField* current() { return depth == 1 ? field : nullptr; }
+
+    bool set(SchemaField::Kind kind) {
+        if (SchemaField* f = current()) {
+            f->kind = kind;
+        }
+        return true;
+    }
+
+    int depth = 0;
+    SchemaField* field = nullptr;
+};
+
+// Convert a field to a value of the cvar's type. Returns an error message, or nullptr.
+static const char* convertField(CvarType type, const SchemaField& field, CvarValue& value) {
+    switch (type) {
+    case CvarType::Bool:
+        if (field.kind != SchemaField::Boolean) return "expected true or false";
+        value.boolValue = field.boolean;
+        return nullptr;
+    case CvarType::Int:
+        if (field.kind != SchemaField::Integer && field.kind != SchemaField::Number) return "expected a number";
+        if (field.number < std::numeric_limits<int32_t>::min() || field.number > std::numeric_limits<int32_t>::max()) return "out of range for int";
+        value.intValue = field.kind == SchemaField::Integer ? (int32_t)field.integer : (int32_t)field.number;
+        return nullptr;
+    case CvarType::Float:
+        if (field.kind != SchemaField::Integer && field.kind != SchemaField::Number) return "expected a number";
+        value.floatValue = (float)field.number;
+        return nullptr;
+    case CvarType::Color: {
+        if (field.kind != SchemaField::String) return "expected a \"#RRGGBBAA\" string";
+        std::string_view hex = field.string;
+        if (!hex.empty() && hex[0] == '#') hex.remove_prefix(1);
+        return parseCvarValue(CvarType::Color, hex, value) ? nullptr : "invalid color";
+    }
+    }
+    return "unknown type";
+}
+
+bool CvarSchemaFile::parseEntry(const Span& span, CvarSchemaEntry& record) const {
+    SchemaEntrySax sax;
+    if (!json::sax_parse(file.data() + span.begin, file.data() + span.end, &sax)) {
+        std::cerr << path << ": byte " << span.begin + sax.errorPosition << ": cvar " << span.name
+                  << ": invalid JSON near '" << sax.errorToken << "'" << std::endl;
+        return false;
+    }
+
+    auto report = [&](const char* message) {
+        std::cerr << path << ": cvar " << span.name << ": " << message << std::endl;
+        return false;
+    };
+    if (!sax.isObject) {
+        return report("expected an object");
+    }
+    CvarType type;
+    if (sax.type.kind != SchemaField::String || !parseCvarType(sax.type.string, type)) {
+        return report("unknown or missing \"type\"");
+    }
+
+    // Bools and colors only have a default
+    record = CvarSchemaEntry{span.name, type, CvarValue(), CvarValue(), CvarValue()};
+    bool ranged = type == CvarType::Int || type == CvarType::Float;
+    auto convert = [&](const char* name, const SchemaField& field, CvarValue& value) {
+        const char* message = field.kind == SchemaField::Missing ? "missing" : convertField(type, field, value);
+        if (message) {
+            std::cerr << path << ": cvar " << span.name << ": \"" << name << "\": " << message << std::endl;
+        }
+        return message == nullptr;
+    };
+    return convert("default", sax.defaultValue, record.defaultValue) &&
+           (!ranged || (convert("min", sax.minValue, record.minValue) && convert("max", sax.maxValue, record.maxValue)));
+}
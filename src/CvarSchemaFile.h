@@ -0,0 +1,44 @@
+#ifndef CVARSCHEMAFILE_H
+#define CVARSCHEMAFILE_H
+
+#include "CvarSchema.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A cvars.json schema file, {"<name>": {"type": ..., "default": ..., "min": ..., "max": ...}},
+// read without building a JSON tree.
+//
+// open() maps the file and walks its top-level object to find where each entry's text is,
+// then parses that text with nlohmann's SAX interface into a compact record. Bad entries
+// are reported and skipped instead of throwing out of the load.
+class CvarSchemaFile {
+public:
+    // Map the file and parse every entry. Fails if it is missing or not a JSON object.
+    bool open(const std::string& filename);
+
+    // Valid entries in file order. Their names stay valid while the file is open.
+    const std::vector<CvarSchemaEntry>& entries() const { return records; }
+
+private:
+    // Where an entry is in the mapping
+    struct Span {
+        std::string_view name;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    bool fail(size_t offset, const char* message) const;
+    bool parseEntry(const Span& span, CvarSchemaEntry& record) const;
+
+    std::string path;
+    MappedFile file;
+    std::vector<CvarSchemaEntry> records;
+    std::deque<std::string> unescapedNames; // Names written with escapes in the file
+};
+
+#endif // CVARSCHEMAFILE_H
@@ -0,0 +1,146 @@
+#include "EditHistory.h"
+#include "ControlsManager.h"
+#include <memory>
+
+// One undoable change; before/after hold only what the edit touched
+struct EditRecord {
+    Cvar* cvar = nullptr; // Set for cvar edits; cvars are never erased, so the pointer stays valid
+    CvarValue before;
+    CvarValue after;
+    std::string command;  // Set for control edits
+    std::string beforeKey;
+    std::string afterKey;
+    bool actions = false; // Whether beforeKey/afterKey are actions strings rather than key tokens
+};
+
+// Node of a persistent list; a node is immutable once linked, so stacks can share tails
+struct EditNode {
+    std::shared_ptr<const EditRecord> record;
+    std::shared_ptr<const EditNode> next;
+};
+
+using EditList = std::shared_ptr<const EditNode>;
+
+static EditList undoStack;
+static EditList redoStack;
+static bool groupOpen = false; // Whether the newest undo entry may still absorb edits
+
+static EditList push(const EditList& list, std::shared_ptr<const EditRecord> record) {
+    return std::make_shared<const EditNode>(EditNode{std::move(record), list});
+}
+
+// Drop a list iteratively; letting a long list destroy itself would recurse once per node
+static void release(EditList& list) {
+    while (list && list.use_count() == 1) {
+        EditList next = list->next;
+        list = std::move(next);
+    }
+    list.reset();
+}
+
+static void pushEdit(std::shared_ptr<const EditRecord> record) {
+    undoStack = push(undoStack, std::move(record));
+    release(redoStack); // A new edit starts a new branch
+}
+
+void recordCvarEdit(Cvar& cvar, CvarValue before) {
+    // Merge into the open entry for the same cvar, keeping its original before value
+    if (groupOpen && undoStack && undoStack->record->cvar == &cvar) {
+        auto merged = std::make_shared<EditRecord>(*undoStack->record);
+        merged->after = cvar.value;
+        undoStack = push(undoStack->next, std::move(merged));
+        return;
+    }
+
+    auto record = std::make_shared<EditRecord>();
+    record->cvar = &cvar;
+    record->before = before;
+    record->after = cvar.value;
+    pushEdit(std::move(record));
+    groupOpen = true;
+}
+
+void recordControlEdit(const std::string& command, const std::string& before, const std::string& after) {
+    if (before == after) {
+        return;
+    }
+    auto record = std::make_shared<EditRecord>();
+    record->command = command;
+    record->beforeKey = before;
+    record->afterKey = after;
+    pushEdit(std::move(record));
+    groupOpen = false;
+}
+
+void recordActionsEdit(const std::string& command, const std::string& before, const std::string& after) {
+    if (before == after) {
+        return;
+    }
+    auto record = std::make_shared<EditRecord>();
+    record->command = command;
+    record->beforeKey = before;
+    record->afterKey = after;
+    record->actions = true;
+    pushEdit(std::move(record));
+    groupOpen = false;
+}
+
+void endEditGroup() {
+    groupOpen = false;
+}
+
+// Put the record's before (undo) or after (redo) state back. Fails when the actions are
+// now taken by another control.
+static bool applyRecord(const EditRecord& record, bool undo) {
+    if (record.cvar) {
+        record.cvar->value = undo ? record.before : record.after;
+        return true;
+    }
+    if (record.actions) {
+        return setControlActions(record.command, std::string_view(undo ? record.beforeKey : record.afterKey));
+    }
+    setControlKey(record.command, undo ? record.beforeKey : record.afterKey);
+    return true;
+}
+
+bool undoEdit() {
+    if (!undoStack) {
+        return false;
+    }
+    EditList node = undoStack;
+    if (!applyRecord(*node->record, true)) {
+        return false;
+    }
+    undoStack = node->next;
+    redoStack = push(redoStack, node->record);
+    groupOpen = false;
+    return true;
+}
+
+bool redoEdit() {
+    if (!redoStack) {
+        return false;
+    }
+    EditList node = redoStack;
+    if (!applyRecord(*node->record, false)) {
+        return false;
+    }
+    redoStack = node->next;
+    undoStack = push(undoStack, node->record);
+    groupOpen = false;
+    return true;
+}
+
+bool canUndo() {
+    return undoStack != nullptr;
+}
+
+bool canRedo() {
+    return redoStack != nullptr;
+}
+
+void clearEditHistory() {
+    release(undoStack);
+    release(redoStack);
+    groupOpen = false;
+}
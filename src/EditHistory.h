@@ -0,0 +1,35 @@
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <string>
+#include "CvarManager.h"
+
+// Undo/redo history of edits made in the editors. The undo and redo stacks are
+// persistent singly linked lists whose nodes are shared, never copied: an edit adds
+// one node holding only the changed value, and undo/redo move one record between the
+// stacks, so both take constant time however large the config is.
+//
+// Edits made while a widget is held (a slider drag, a color pick) merge into a single
+// entry; endEditGroup closes it when the widget is released.
+
+// Record a change of a cvar from before to its current value
+void recordCvarEdit(Cvar& cvar, CvarValue before);
+
+// Record a named control moving from one key token (e.g. "+f3") to another
+void recordControlEdit(const std::string& command, const std::string& before, const std::string& after);
+
+// Record a named control's actions changing from one "a;b;c" string to another
+void recordActionsEdit(const std::string& command, const std::string& before, const std::string& after);
+
+// Stop merging further edits into the newest entry
+void endEditGroup();
+
+// Both return false when there is nothing to undo or redo, or the edit no longer applies
+// because another control has taken its actions
+bool undoEdit();
+bool redoEdit();
+bool canUndo();
+bool canRedo();
+void clearEditHistory();
+
+#endif // EDITHISTORY_H
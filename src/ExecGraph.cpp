@@ -0,0 +1,309 @@
+#include "ExecGraph.h"
+#include "ConfigDocument.h"
+#include "CvarManager.h"
+#include "ControlsManager.h"
+#include "BindTable.h"
+#include "ConfigArena.h"
+#include "EditHistory.h"
+#include "Trace.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+// A parsed file of the exec graph
+struct ExecFile {
+    std::string path;
+    int64_t mtime = 0;
+    uint64_t size = 0;
+    bool found = false;
+    ConfigDocument document;
+    std::vector<std::string> execs; // Paths of the files it executes, in order
+};
+
+// Parsed files by path, reused while their size and modification time are unchanged
+static std::mutex execCacheMutex;
+static std::map<std::string, std::shared_ptr<const ExecFile>> execCache;
+
+static std::vector<std::string> lastTreeFiles;
+static std::set<std::string> missingTreeFiles; // Exec targets the last load could not open
+static std::vector<std::string> lastTreeCommands; // Lines of the last load that set no cvar or bind
+static std::map<std::string, size_t, std::less<>> execRanks; // When each file, missing ones too, last ran
+static size_t execCount = 0;                                   // Files executed so far by the last load
+
+// Target of an exec line. Like the game, paths are relative to the working directory.
+bool execTarget(const ConfigLine& line, std::string& target) {
+    if (line.kind != ConfigLineKind::Command || line.command != "exec") {
+        return false;
+    }
+    std::string_view name = line.quoted ? line.actions : line.key;
+    if (name.empty()) {
+        return false;
+    }
+    target = fs::path(std::string(name)).lexically_normal().generic_string();
+    return true;
+}
+
+static std::shared_ptr<const ExecFile> parseExecFile(const std::string& path) {
+    TRACE_ZONE("parseExecFile");
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    int64_t mtime = ec ? 0 : (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    bool exists = !ec;
+
+    if (exists) {
+        std::lock_guard<std::mutex> lock(execCacheMutex);
+        auto cached = execCache.find(path);
+        if (cached != execCache.end() && cached->second->mtime == mtime && cached->second->size == size) {
+            return cached->second;
+        }
+    }
+
+    auto file = std::make_shared<ExecFile>();
+    file->path = path;
+    file->mtime = mtime;
+    file->size = size;
+    file->found = exists && file->document.load(path);
+    if (file->found) {
+        std::string target;
+        for (const ConfigLine& line : file->document.lines()) {
+            if (execTarget(line, target)) {
+                file->execs.push_back(target);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(execCacheMutex);
+        execCache[path] = file;
+    }
+    return file;
+}
+
+// Shared state of the discovery of one load
+struct ExecScan {
+    WorkStealingPool pool;
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const ExecFile>> files; // Null while being parsed
+};
+
+// Parse one file and queue the files it executes that no other task has claimed, so
+// independent files parse in parallel without waiting for the rest of their level
+static void scanExecFile(ExecScan& scan, const std::string& path) {
+    std::shared_ptr<const ExecFile> file = parseExecFile(path);
+
+    std::lock_guard<std::mutex> lock(scan.mutex);
+    scan.files[path] = file;
+    for (const std::string& target : file->execs) {
+        if (scan.files.emplace(target, nullptr).second) {
+            scan.pool.submit([&scan, target] { scanExecFile(scan, target); });
+        }
+    }
+}
+
+// Apply one file, descending into exec lines as the engine does
+static void applyExecFile(const std::string& path,
+                          const std::map<std::string, std::shared_ptr<const ExecFile>>& files,
+                          std::vector<std::string>& stack,
+                          std::set<std::string>& visited) {
+    if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+        std::cerr << "Exec cycle:";
+        for (const std::string& entry : stack) {
+            std::cerr << " " << entry << " ->";
+        }
+        std::cerr << " " << path << " (skipped)" << std::endl;
+        return;
+    }
+
+    execRanks[path] = ++execCount;
+
+    const ExecFile& file = *files.at(path);
+    if (!file.found) {
+        std::cerr << "Failed to open " << path << std::endl;
+        missingTreeFiles.insert(path);
+        return;
+    }
+    if (visited.insert(path).second) {
+        lastTreeFiles.push_back(path);
+    }
+
+    stack.push_back(path);
+    std::string target;
+    for (const ConfigLine& line : file.document.lines()) {
+        if (line.kind != ConfigLineKind::Command) {
+            continue;
+        }
+        if (execTarget(line, target)) {
+            applyExecFile(target, files, stack, visited);
+        } else if (!applyCvarLine(line, path) && !applyControlLine(line, path)) {
+            lastTreeCommands.emplace_back(line.text);
+        }
+    }
+    stack.pop_back();
+}
+
+// Discover the files reached from the roots and apply them, the roots in order
+static void loadExecRoots(const std::vector<std::string>& roots) {
+    // Discover the graph on one pool; every parsed file queues the files it executes
+    ExecScan scan;
+    {
+        std::lock_guard<std::mutex> lock(scan.mutex);
+        for (const std::string& root : roots) {
+            if (scan.files.emplace(root, nullptr).second) {
+                scan.pool.submit([&scan, root] { scanExecFile(scan, root); });
+            }
+        }
+    }
+    scan.pool.wait();
+    const std::map<std::string, std::shared_ptr<const ExecFile>>& files = scan.files;
+
+    // Apply everything in exec order. Undo must not bring back values from before the load.
+    clearEditHistory();
+    bindTable.clear();
+    lastTreeFiles.clear();
+    missingTreeFiles.clear();
+    lastTreeCommands.clear();
+    execRanks.clear();
+    execCount = 0;
+    std::vector<std::string> stack;
+    std::set<std::string> visited;
+    for (const std::string& root : roots) {
+        applyExecFile(root, files, stack, visited);
+    }
+
+    invalidateCvarView();
+    invalidateActionNames(); // New aliases
+}
+
+bool loadConfigTree(const std::string& rootFilename) {
+    TRACE_ZONE("loadConfigTree");
+    if (!fs::exists(rootFilename)) {
+        return false;
+    }
+
+    loadExecRoots({fs::path(rootFilename).lexically_normal().generic_string()});
+    std::cout << "Configuration loaded from " << rootFilename << " (" << lastTreeFiles.size() << " files, "
+              << bindTable.size() << " binds in " << formatByteCount(bindTable.memoryInUse()) << ", peak "
+              << formatByteCount(bindTable.memoryHighWaterMark()) << ")" << std::endl;
+    return true;
+}
+
+bool loadConfigFiles(const std::vector<std::string>& filenames) {
+    TRACE_ZONE("loadConfigFiles");
+    std::vector<std::string> roots;
+    for (const std::string& filename : filenames) {
+        roots.push_back(fs::path(filename).lexically_normal().generic_string());
+    }
+
+    loadExecRoots(roots);
+    if (lastTreeFiles.empty()) {
+        return false;
+    }
+    std::cout << "Configuration loaded from " << lastTreeFiles.size() << " files (" << bindTable.size() << " binds)" << std::endl;
+    return true;
+}
+
+bool reloadConfigFile(const std::string& path) {
+    TRACE_ZONE("reloadConfigFile");
+    const std::string key = fs::path(path).lexically_normal().generic_string();
+    if (missingTreeFiles.count(key) != 0) {
+        // Created since the load: everything in it is new
+        std::shared_ptr<const ExecFile> created = parseExecFile(key);
+        if (!created->found) {
+            return false;
+        }
+        missingTreeFiles.erase(key);
+        lastTreeFiles.push_back(key);
+        ConfigDocument empty;
+        size_t changes = mergeCvarChanges(key, empty, created->document);
+        changes += mergeControlChanges(key, empty, created->document);
+        clearEditHistory();
+        std::cout << "Loaded " << key << " (" << changes << " changes)" << std::endl;
+        return true;
+    }
+    if (std::find(lastTreeFiles.begin(), lastTreeFiles.end(), key) == lastTreeFiles.end()) {
+        return false;
+    }
+
+    // The cached parse is what was applied last, the base of the merge
+    std::shared_ptr<const ExecFile> before;
+    {
+        std::lock_guard<std::mutex> lock(execCacheMutex);
+        auto cached = execCache.find(key);
+        if (cached == execCache.end()) {
+            return false;
+        }
+        before = cached->second;
+        execCache.erase(cached); // Force a re-read even if size and time look the same
+    }
+
+    std::shared_ptr<const ExecFile> after = parseExecFile(key);
+    if (!after->found) {
+        std::lock_guard<std::mutex> lock(execCacheMutex);
+        execCache[key] = before; // Mid-replace or deleted; keep the last good parse
+        return false;
+    }
+    if (after->document.text() == before->document.text()) {
+        return false; // E.g. our own save
+    }
+
+    size_t changes = mergeCvarChanges(key, before->document, after->document);
+    changes += mergeControlChanges(key, before->document, after->document);
+
+    // Later saves patch the new text
+    ConfigDocument& document = editorDocument(key);
+    if (document.isLoaded()) {
+        document.assign(key, after->document.text());
+    }
+    if (changes > 0) {
+        // The history's before values may be what the file just replaced
+        clearEditHistory();
+        std::cout << "Reloaded " << key << " (" << changes << " changes)" << std::endl; // Quiet after our own saves
+    }
+    return true;
+}
+
+std::vector<std::string> configTreeFiles() {
+    return lastTreeFiles;
+}
+
+std::vector<std::string> configTreeCommands() {
+    return lastTreeCommands;
+}
+
+std::vector<std::string> configTreeAliases() {
+    std::vector<std::string> names;
+    std::lock_guard<std::mutex> lock(execCacheMutex);
+    for (const std::string& path : lastTreeFiles) {
+        auto cached = execCache.find(path);
+        if (cached == execCache.end()) {
+            continue;
+        }
+        for (const ConfigLine& line : cached->second->document.lines()) {
+            if (line.command == "alias" && !line.key.empty()) {
+                names.emplace_back(line.key);
+            }
+        }
+    }
+    return names;
+}
+
+bool execsAfter(std::string_view a, std::string_view b) {
+    auto rankA = execRanks.find(a);
+    auto rankB = execRanks.find(b);
+    if (rankA == execRanks.end() || rankB == execRanks.end()) {
+        return rankA == execRanks.end() && rankB != execRanks.end();
+    }
+    return rankA->second > rankB->second;
+}
+
+std::vector<std::string> configWatchList() {
+    std::vector<std::string> files = lastTreeFiles;
+    files.insert(files.end(), missingTreeFiles.begin(), missingTreeFiles.end());
+    return files;
+}
@@ -0,0 +1,48 @@
+#ifndef EXECGRAPH_H
+#define EXECGRAPH_H
+
+#include "ConfigLexer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Load the config tree rooted at rootFilename (normally cfg/autoexec.cfg) the way the game does.
+// "exec" lines are followed to discover the files, independent files are parsed in parallel,
+// and every line is then applied to the cvars and controls in the engine's exec order.
+// Paths in exec lines are relative to the working directory. Parsed files are cached by
+// path and modification time, and exec cycles are reported and skipped.
+bool loadConfigTree(const std::string& rootFilename);
+
+// Load files in order as if one root file executed each of them, e.g. the editor's own
+// files when there is no autoexec.cfg. Returns false if none of them exists.
+bool loadConfigFiles(const std::vector<std::string>& filenames);
+
+// Files reached by the last load, in the order they were first executed
+std::vector<std::string> configTreeFiles();
+
+// Command lines of the last load other than exec lines, cvar assignments and the binds in
+// the bind table (e.g. mod, alias and hud lines), in the order they ran
+std::vector<std::string> configTreeCommands();
+
+// Names of the aliases defined by the files of the last load
+std::vector<std::string> configTreeAliases();
+
+// Whether the last load executed file a after file b, by the last time each was executed.
+// Files it did not execute, and the editor's own binds (an empty name), count as last.
+bool execsAfter(std::string_view a, std::string_view b);
+
+// Files to watch for the last load: the ones it read, and the exec targets that did not
+// exist, so that creating one is noticed
+std::vector<std::string> configWatchList();
+
+// Re-read one file of the loaded tree after it changed on disk and merge the difference
+// into the cvars and controls, keeping values edited in the editor since the last read.
+// A file that was missing at load time is applied as a whole once it appears. Exec lines
+// of the file are not followed again. Returns false if the file is not part of the tree
+// or its text did not change.
+bool reloadConfigFile(const std::string& path);
+
+// Normalized target path of an "exec" line. Returns false for any other line.
+bool execTarget(const ConfigLine& line, std::string& target);
+
+#endif // EXECGRAPH_H
@@ -0,0 +1,189 @@
+#include "FileWatcher.h"
+#include "FrameScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static std::mutex watcherMutex;
+static std::set<std::string> watchedFiles;  // Normalized paths
+static std::set<std::string> changedFiles;
+static std::thread watcherThread;
+static std::atomic<bool> watcherStopping{false};
+static std::atomic<bool> watchListChanged{false};
+
+static std::string normalizedPath(const fs::path& path) {
+    return path.lexically_normal().generic_string();
+}
+
+// Record a change to a watched file and wake the main loop
+static void noteChange(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        if (watchedFiles.count(path) == 0 || !changedFiles.insert(path).second) {
+            return;
+        }
+    }
+    requestRedraw();
+}
+
+static std::set<std::string> currentWatchList() {
+    std::lock_guard<std::mutex> lock(watcherMutex);
+    return watchedFiles;
+}
+
+#ifdef __linux__
+
+// Watch the directories of the files rather than the files themselves: atomic saves
+// replace the file with a new inode, which a watch on the old inode would never see. It
+// also catches a watched file being created. A directory that does not exist yet is
+// retried until it does.
+static void runWatcher() {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
+    std::map<int, std::string> directories; // Watch descriptor to directory
+    std::set<std::string> missingDirectories;
+    alignas(struct inotify_event) char buffer[4096];
+    while (!watcherStopping) {
+        if (watchListChanged.exchange(false)) {
+            for (const auto& [wd, directory] : directories) {
+                inotify_rm_watch(fd, wd);
+            }
+            directories.clear();
+            missingDirectories.clear();
+
+            for (const std::string& file : currentWatchList()) {
+                std::string directory = fs::path(file).parent_path().generic_string();
+                missingDirectories.insert(directory.empty() ? "." : directory);
+            }
+        }
+        for (auto it = missingDirectories.begin(); it != missingDirectories.end();) {
+            int wd = inotify_add_watch(fd, it->c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0) {
+                ++it;
+                continue;
+            }
+            directories[wd] = *it;
+            it = missingDirectories.erase(it);
+        }
+
+        // Wake up regularly to notice a new watch list or a stop request
+        pollfd request = {fd, POLLIN, 0};
+        if (poll(&request, 1, 250) <= 0) {
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                auto directory = directories.find(event->wd);
+                if (event->len > 0 && directory != directories.end()) {
+                    noteChange(normalizedPath(fs::path(directory->second) / event->name));
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+    close(fd);
+}
+
+#else
+
+// Compare modification time and size of every file twice a second
+static void runWatcher() {
+    struct Stamp {
+        fs::file_time_type mtime;
+        uintmax_t size = 0;
+        bool exists = false;
+    };
+
+    std::map<std::string, Stamp> stamps;
+    auto stampOf = [](const std::string& file) {
+        std::error_code ec;
+        Stamp stamp;
+        stamp.size = fs::file_size(file, ec);
+        stamp.exists = !ec;
+        if (stamp.exists) {
+            stamp.mtime = fs::last_write_time(file, ec);
+        }
+        return stamp;
+    };
+
+    while (!watcherStopping) {
+        if (watchListChanged.exchange(false)) {
+            stamps.clear();
+            for (const std::string& file : currentWatchList()) {
+                stamps[file] = stampOf(file);
+            }
+        }
+
+        for (auto& [file, stamp] : stamps) {
+            Stamp current = stampOf(file);
+            if (current.exists != stamp.exists || current.size != stamp.size || current.mtime != stamp.mtime) {
+                stamp = current;
+                if (current.exists) {
+                    noteChange(file);
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+}
+
+#endif
+
+void watchFiles(const std::vector<std::string>& filenames) {
+    {
+        std::set<std::string> files;
+        for (const std::string& file : filenames) {
+            files.insert(normalizedPath(file));
+        }
+
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        if (files == watchedFiles && watcherThread.joinable()) {
+            return; // Keep the watches; re-adding them could miss an event
+        }
+        watchedFiles = std::move(files);
+        for (auto it = changedFiles.begin(); it != changedFiles.end();) {
+            it = watchedFiles.count(*it) != 0 ? std::next(it) : changedFiles.erase(it);
+        }
+    }
+    watchListChanged = true;
+
+    if (!watcherThread.joinable()) {
+        watcherStopping = false;
+        watcherThread = std::thread(runWatcher);
+    }
+}
+
+std::vector<std::string> takeChangedFiles() {
+    std::lock_guard<std::mutex> lock(watcherMutex);
+    std::vector<std::string> changed(changedFiles.begin(), changedFiles.end());
+    changedFiles.clear();
+    return changed;
+}
+
+void stopFileWatcher() {
+    watcherStopping = true;
+    if (watcherThread.joinable()) {
+        watcherThread.join();
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <string>
+#include <vector>
+
+// Watches config files for changes made by other programs (the game, a text editor).
+// Uses inotify on Linux and polls modification times elsewhere. Changes wake the main
+// loop through requestRedraw; the main thread then collects them with takeChangedFiles.
+
+// Watch exactly these files, replacing any earlier list. Files that do not exist yet are
+// reported once they are created.
+void watchFiles(const std::vector<std::string>& filenames);
+
+// Files that changed since the last call, each listed once
+std::vector<std::string> takeChangedFiles();
+
+// Stop the watcher thread
+void stopFileWatcher();
+
+#endif // FILEWATCHER_H
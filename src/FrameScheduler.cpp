@@ -0,0 +1,37 @@
+#include "FrameScheduler.h"
+#include <SDL.h>
+#include <atomic>
+
+static std::atomic<int> pendingFrames{1}; // Always draw the first frame
+static Uint32 redrawEventType = (Uint32)-1;
+
+void initFrameScheduler() {
+    redrawEventType = SDL_RegisterEvents(1);
+}
+
+void requestRedraw(int frames) {
+    int previous = pendingFrames.load();
+    while (previous < frames && !pendingFrames.compare_exchange_weak(previous, frames)) {
+    }
+
+    // Wake a main loop blocked in SDL_WaitEventTimeout
+    if (previous == 0 && redrawEventType != (Uint32)-1) {
+        SDL_Event event = {};
+        event.type = redrawEventType;
+        SDL_PushEvent(&event);
+    }
+}
+
+bool redrawPending() {
+    return pendingFrames.load() > 0;
+}
+
+void frameDrawn() {
+    int previous = pendingFrames.load();
+    while (previous > 0 && !pendingFrames.compare_exchange_weak(previous, previous - 1)) {
+    }
+}
+
+bool isRedrawEvent(unsigned int eventType) {
+    return redrawEventType != (Uint32)-1 && eventType == redrawEventType;
+}
@@ -0,0 +1,22 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+// Decides when the main loop has to draw while power saving is enabled.
+// Without pending redraws the loop blocks until the next event arrives.
+
+// Register the wakeup event. Call after SDL_Init.
+void initFrameScheduler();
+
+// Ask for at least `frames` more frames. Safe to call from any thread; wakes the main loop.
+void requestRedraw(int frames = 1);
+
+// Whether a frame is still owed to a redraw request
+bool redrawPending();
+
+// Called by the main loop after each drawn frame
+void frameDrawn();
+
+// Whether an event is the scheduler's own wakeup event
+bool isRedrawEvent(unsigned int eventType);
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,83 @@
+#ifndef KEYNAMES_H
+#define KEYNAMES_H
+
+#include "keycode.h"
+#include "keystr.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "KeyNames.gen.h" // Seeds and slots of the hash, from tools/gen_keynames.py
+
+// Lookups between key names (as used in bind lines) and scancodes in both directions.
+// Names map to scancodes through a minimal perfect hash over keystr. The hash is searched
+// for at build time by tools/gen_keynames.py; the static_asserts below check it.
+
+namespace keynames_detail {
+
+// Number of scancodes that have a name
+constexpr size_t countNamedKeys() {
+    size_t count = 0;
+    for (size_t i = 0; i < KEYSTR_MAX; ++i) {
+        if (keystr[i][0] != '\0') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// FNV-1a, varied by seed; must match hash_key_name in tools/gen_keynames.py
+constexpr uint32_t hashKeyName(uint32_t seed, std::string_view name) {
+    uint32_t hash = 2166136261u ^ (seed * 16777619u);
+    for (char c : name) {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash;
+}
+
+static_assert(keyCount == countNamedKeys(), "KeyNames.gen.h out of step with keystr");
+
+} // namespace keynames_detail
+
+// Name of a scancode, or "" if it is out of range or has no name
+constexpr std::string_view keyName(int scancode) {
+    return scancode >= 0 && scancode < KEYSTR_MAX ? std::string_view(keystr[scancode]) : std::string_view();
+}
+
+// Scancode of a key name, or -1 if there is no such key
+constexpr int keyScancode(std::string_view name) {
+    using namespace keynames_detail;
+    if (name.empty()) {
+        return -1;
+    }
+    uint16_t seed = keyHashSeeds[hashKeyName(0, name) % bucketCount];
+    uint8_t scancode = keyHashScancodes[hashKeyName(seed, name) % keyCount];
+    return name == keystr[scancode] ? scancode : -1;
+}
+
+namespace keynames_detail {
+
+// Every named scancode must survive a round trip through its name
+constexpr bool keyTablesRoundTrip() {
+    for (int i = 0; i < KEYSTR_MAX; ++i) {
+        if (keystr[i][0] != '\0' && keyScancode(keyName(i)) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace keynames_detail
+
+static_assert(KEYSTR_MAX == KEY_RGUI + 1, "keystr must cover the keyboard scancodes of keycode.h");
+static_assert(keynames_detail::keyTablesRoundTrip(), "key name hash does not round-trip");
+static_assert(keyScancode("a") == KEY_A && keyScancode("z") == KEY_Z, "keystr out of step with keycode.h");
+static_assert(keyScancode("1") == KEY_1 && keyScancode("0") == KEY_0, "keystr out of step with keycode.h");
+static_assert(keyScancode("return") == KEY_RETURN && keyScancode("space") == KEY_SPACE, "keystr out of step with keycode.h");
+static_assert(keyScancode("f1") == KEY_F1 && keyScancode("f12") == KEY_F12, "keystr out of step with keycode.h");
+static_assert(keyScancode("up") == KEY_UP && keyScancode("kp_minus") == KEY_KP_MINUS, "keystr out of step with keycode.h");
+static_assert(keyScancode("kp_00") == KEY_KP_00 && keyScancode("kp_hexadecimal") == KEY_KP_HEXADECIMAL, "keystr out of step with keycode.h");
+static_assert(keyScancode("lctrl") == KEY_LCTRL && keyScancode("rgui") == KEY_RGUI, "keystr out of step with keycode.h");
+static_assert(keyScancode("spacebar") == -1 && keyScancode("") == -1, "unknown names must not resolve");
+static_assert(keyName(-1).empty() && keyName(KEYSTR_MAX).empty(), "out-of-range scancodes have no name");
+
+#endif // KEYNAMES_H
@@ -0,0 +1,208 @@
+#include "SchemaCache.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+static const char schemaCacheMagic[4] = {'O', 'K', 'S', 'C'};
+static const uint32_t schemaCacheVersion = 1;
+
+struct SchemaCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;  // Size of the schema file the image was built from
+    int64_t sourceMtime;  // Modification time of that file
+    uint32_t recordCount;
+    uint32_t poolSize;
+};
+
+struct SchemaCacheRecord {
+    uint32_t nameOffset; // Offset of the name in the string pool
+    uint16_t nameLength;
+    uint8_t type;        // CvarType
+    uint8_t reserved;
+    uint32_t defaultValue;
+    uint32_t minValue;
+    uint32_t maxValue;
+};
+
+static_assert(sizeof(SchemaCacheHeader) == 32, "schema cache header must have a fixed layout");
+static_assert(sizeof(SchemaCacheRecord) == 20, "schema cache record must have a fixed layout");
+static_assert(sizeof(CvarValue) == sizeof(uint32_t), "cvar values are stored as 32-bit words");
+
+static fs::path cacheDirectory() {
+#ifdef _WIN32
+    const char* base = std::getenv("LOCALAPPDATA");
+    return base && *base ? fs::path(base) / "okesl-config" / "cache" : fs::path();
+#else
+    if (const char* base = std::getenv("XDG_CACHE_HOME"); base && *base) {
+        return fs::path(base) / "okesl-config";
+    }
+    const char* home = std::getenv("HOME");
+    return home && *home ? fs::path(home) / ".cache" / "okesl-config" : fs::path();
+#endif
+}
+
+// One image per schema file, named after a hash of its absolute path
+std::string SchemaCache::path(const std::string& jsonFilename) {
+    fs::path directory = cacheDirectory();
+    std::error_code ec;
+    fs::path absolute = fs::absolute(jsonFilename, ec);
+    if (directory.empty() || ec) {
+        return std::string();
+    }
+
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (char c : absolute.lexically_normal().generic_string()) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "schema-%016llx.cache", static_cast<unsigned long long>(hash));
+    return (directory / name).string();
+}
+
+// Size and modification time identifying the current version of the schema file
+static bool sourceStamp(const std::string& jsonFilename, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = static_cast<uint64_t>(fs::file_size(jsonFilename, ec));
+    if (ec) {
+        return false;
+    }
+    auto time = fs::last_write_time(jsonFilename, ec);
+    if (ec) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+// Values are stored as their raw 32-bit pattern regardless of the active member
+static uint32_t toWord(CvarValue value) {
+    return value.colorValue;
+}
+
+static CvarValue fromWord(uint32_t word) {
+    return CvarValue(word);
+}
+
+bool SchemaCache::open(const std::string& jsonFilename) {
+    records = nullptr;
+    pool = nullptr;
+    recordCount = 0;
+
+    uint64_t size;
+    int64_t mtime;
+    const std::string cacheFile = path(jsonFilename);
+    if (cacheFile.empty() || !sourceStamp(jsonFilename, size, mtime) || !file.open(cacheFile)) {
+        return false;
+    }
+
+    SchemaCacheHeader header;
+    if (file.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, schemaCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != schemaCacheVersion ||
+        header.sourceSize != size || header.sourceMtime != mtime) {
+        return false; // Foreign or stale image
+    }
+
+    size_t recordsSize = static_cast<size_t>(header.recordCount) * sizeof(SchemaCacheRecord);
+    if (file.size() != sizeof(header) + recordsSize + header.poolSize) {
+        return false; // Truncated image
+    }
+
+    records = file.data() + sizeof(header);
+    pool = records + recordsSize;
+    recordCount = header.recordCount;
+
+    // Reject names pointing outside the pool so entry() never reads out of bounds
+    for (size_t i = 0; i < recordCount; ++i) {
+        SchemaCacheRecord record;
+        std::memcpy(&record, records + i * sizeof(record), sizeof(record));
+        if (static_cast<uint64_t>(record.nameOffset) + record.nameLength > header.poolSize ||
+            record.type > static_cast<uint8_t>(CvarType::Color)) {
+            records = nullptr;
+            pool = nullptr;
+            recordCount = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+CvarSchemaEntry SchemaCache::entry(size_t index) const {
+    SchemaCacheRecord record;
+    std::memcpy(&record, records + index * sizeof(record), sizeof(record));
+
+    CvarSchemaEntry entry;
+    entry.name = std::string_view(pool + record.nameOffset, record.nameLength);
+    entry.type = static_cast<CvarType>(record.type);
+    entry.defaultValue = fromWord(record.defaultValue);
+    entry.minValue = fromWord(record.minValue);
+    entry.maxValue = fromWord(record.maxValue);
+    return entry;
+}
+
+bool SchemaCache::write(const std::string& jsonFilename, const std::vector<CvarSchemaEntry>& entries) {
+    SchemaCacheHeader header = {};
+    std::memcpy(header.magic, schemaCacheMagic, sizeof(header.magic));
+    header.version = schemaCacheVersion;
+    if (!sourceStamp(jsonFilename, header.sourceSize, header.sourceMtime)) {
+        return false;
+    }
+
+    std::vector<SchemaCacheRecord> table;
+    std::string stringPool;
+    table.reserve(entries.size());
+    for (const CvarSchemaEntry& entry : entries) {
+        if (entry.name.size() > UINT16_MAX) {
+            return false;
+        }
+        SchemaCacheRecord record = {};
+        record.nameOffset = static_cast<uint32_t>(stringPool.size());
+        record.nameLength = static_cast<uint16_t>(entry.name.size());
+        record.type = static_cast<uint8_t>(entry.type);
+        record.defaultValue = toWord(entry.defaultValue);
+        record.minValue = toWord(entry.minValue);
+        record.maxValue = toWord(entry.maxValue);
+        table.push_back(record);
+        stringPool += entry.name;
+    }
+    header.recordCount = static_cast<uint32_t>(table.size());
+    header.poolSize = static_cast<uint32_t>(stringPool.size());
+
+    // Write to a temporary file first so a reader never maps a partial image
+    const std::string cacheFile = path(jsonFilename);
+    if (cacheFile.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::path(cacheFile).parent_path(), ec);
+    const std::string tempPath = cacheFile + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SchemaCacheRecord)));
+        out.write(stringPool.data(), static_cast<std::streamsize>(stringPool.size()));
+        if (!out) {
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, cacheFile, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef SCHEMACACHE_H
+#define SCHEMACACHE_H
+
+#include "CvarSchema.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Binary image of a parsed cvar schema file, stored in the user's cache directory
+// ($XDG_CACHE_HOME or ~/.cache, %LOCALAPPDATA% on Windows) rather than next to the schema,
+// which may be read-only. The image is a header, a flat array of fixed-size records and a
+// string pool, and is only used while the schema file's size and modification time match
+// the header.
+class SchemaCache {
+public:
+    // Map the cache of jsonFilename. Fails if it is missing, corrupt or stale.
+    bool open(const std::string& jsonFilename);
+
+    size_t size() const { return recordCount; }
+
+    // Entry i of the mapped image; its name points into the mapping
+    CvarSchemaEntry entry(size_t index) const;
+
+    // Write the cache of jsonFilename from its parsed entries
+    static bool write(const std::string& jsonFilename, const std::vector<CvarSchemaEntry>& entries);
+
+    // Where the cache of jsonFilename is kept, or empty when there is no cache directory
+    static std::string path(const std::string& jsonFilename);
+
+private:
+    MappedFile file;
+    const char* records = nullptr;
+    const char* pool = nullptr;
+    size_t recordCount = 0;
+};
+
+#endif // SCHEMACACHE_H
@@ -0,0 +1,148 @@
+#ifndef STRINGMAP_H
+#define STRINGMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Hash map from strings to values, looked up by std::string_view without building a key.
+//
+// Entries are kept in insertion order in a deque, so references to them stay valid as the
+// map grows. The lookup table is a flat array of (hash, entry index) pairs probed linearly;
+// a probe compares the stored hash before touching the key. There is no operator[]: an
+// unknown name is never inserted by looking it up. Use sorted() for a by-name order.
+template <typename Value>
+class StringMap {
+public:
+    using value_type = std::pair<const std::pmr::string, Value>;
+    using iterator = typename std::pmr::deque<value_type>::iterator;
+    using const_iterator = typename std::pmr::deque<value_type>::const_iterator;
+
+    explicit StringMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource), slots(resource) {}
+
+    StringMap(std::initializer_list<std::pair<std::string_view, Value>> init,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : StringMap(resource) {
+        reserve(init.size());
+        for (const auto& [key, value] : init) {
+            emplace(key, value);
+        }
+    }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    iterator find(std::string_view key) {
+        size_t slot = findSlot(key, hashKey(key));
+        return slots.empty() || slots[slot].index == 0 ? end() : entries.begin() + (slots[slot].index - 1);
+    }
+
+    const_iterator find(std::string_view key) const {
+        return const_cast<StringMap*>(this)->find(key);
+    }
+
+    bool contains(std::string_view key) const { return find(key) != end(); }
+
+    // Insert key with a value built from args, unless the key is already present
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(std::string_view key, Args&&... args) {
+        if ((entries.size() + 1) * 4 > slots.size() * 3) {
+            rehash(std::max<size_t>(16, slots.size() * 2));
+        }
+
+        uint32_t hash = hashKey(key);
+        size_t slot = findSlot(key, hash);
+        if (slots[slot].index != 0) {
+            return {entries.begin() + (slots[slot].index - 1), false};
+        }
+
+        entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        slots[slot] = {hash, (uint32_t)entries.size()};
+        return {entries.end() - 1, true};
+    }
+
+    // Make room for count entries without growing the table
+    void reserve(size_t count) {
+        size_t capacity = 16;
+        while (count * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        slots.clear();
+    }
+
+    // Every entry, ordered by key
+    std::vector<value_type*> sorted() {
+        std::vector<value_type*> view;
+        view.reserve(entries.size());
+        for (value_type& entry : entries) {
+            view.push_back(&entry);
+        }
+        std::sort(view.begin(), view.end(), [](const value_type* a, const value_type* b) {
+            return a->first < b->first;
+        });
+        return view;
+    }
+
+private:
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t index = 0; // Entry index + 1, or 0 when empty
+    };
+
+    static uint32_t hashKey(std::string_view key) {
+        return (uint32_t)std::hash<std::string_view>()(key);
+    }
+
+    // Slot holding key, or the empty slot where it would go
+    size_t findSlot(std::string_view key, uint32_t hash) const {
+        if (slots.empty()) {
+            return 0;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Slot& probe = slots[slot];
+            if (probe.index == 0 || (probe.hash == hash && entries[probe.index - 1].first == key)) {
+                return slot;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        slots.assign(capacity, Slot());
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            uint32_t hash = hashKey(entries[i].first);
+            size_t slot = hash & mask;
+            while (slots[slot].index != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = {hash, (uint32_t)(i + 1)};
+        }
+    }
+
+    std::pmr::deque<value_type> entries;
+    std::pmr::vector<Slot> slots; // Power-of-two size, at most three quarters full
+};
+
+#endif // STRINGMAP_H
@@ -0,0 +1,176 @@
+#include "Trace.h"
+#include "AsyncSaver.h"
+#include "imgui.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// One slot of the ring. sequence is the index of the event it holds plus one, written
+// after the payload, so readers can tell a finished slot from one being overwritten.
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> startNs{0};
+    std::atomic<uint64_t> endNs{0};
+    std::atomic<uint32_t> thread{0};
+};
+
+struct TraceEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t thread;
+};
+
+static const size_t traceCapacity = 1 << 16; // Power of two
+static std::array<TraceSlot, traceCapacity> traceRing;
+static std::atomic<uint64_t> traceHead{0};
+static std::atomic<uint32_t> nextTraceThread{0};
+
+// Frame durations for the overlay, main thread only
+static const int frameHistory = 240;
+static float frameTimes[frameHistory];
+static float idleTimes[frameHistory]; // From the end of the frame before to the start
+static int frameCount = 0;
+static uint64_t frameStart = 0;     // Of the frame being drawn
+static uint64_t lastFrameStart = 0; // Of the last frame drawn
+static uint64_t lastFrameEnd = 0;
+
+uint64_t traceNow() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Small id of the calling thread
+static uint32_t traceThread() {
+    static thread_local uint32_t id = nextTraceThread++;
+    return id;
+}
+
+void traceZone(const char* name, uint64_t startNs, uint64_t endNs) {
+    uint64_t index = traceHead.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot& slot = traceRing[index & (traceCapacity - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed); // Invalidate while writing
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.endNs.store(endNs, std::memory_order_relaxed);
+    slot.thread.store(traceThread(), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+// Copy the finished events still in the ring that started at or after sinceNs, oldest first
+static std::vector<TraceEvent> traceSnapshot(uint64_t sinceNs) {
+    std::vector<TraceEvent> events;
+    uint64_t head = traceHead.load(std::memory_order_acquire);
+    uint64_t first = head > traceCapacity ? head - traceCapacity : 0;
+    for (uint64_t index = first; index < head; ++index) {
+        const TraceSlot& slot = traceRing[index & (traceCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue; // Not written yet, or already overwritten
+        }
+        TraceEvent event = {slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                            slot.endNs.load(std::memory_order_relaxed), slot.thread.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != index + 1 || event.startNs < sinceNs) {
+            continue;
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+void traceFrameStart() {
+    frameStart = traceNow();
+}
+
+void traceFrame() {
+    uint64_t now = traceNow();
+    if (frameStart == 0) {
+        return;
+    }
+    frameTimes[frameCount % frameHistory] = (float)((now - frameStart) / 1e6);
+    idleTimes[frameCount % frameHistory] = lastFrameEnd != 0 ? (float)((frameStart - lastFrameEnd) / 1e6) : 0.0f;
+    ++frameCount;
+    lastFrameStart = frameStart;
+    lastFrameEnd = now;
+}
+
+void renderTraceOverlay(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame Time", open)) {
+        ImGui::End();
+        return;
+    }
+
+    // Frame times, oldest first
+    int count = std::min(frameCount, frameHistory);
+    float times[frameHistory];
+    float total = 0.0f;
+    float longest = 0.0f;
+    float idle = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        times[i] = frameTimes[(frameCount - count + i) % frameHistory];
+        total += times[i];
+        longest = std::max(longest, times[i]);
+        idle += idleTimes[(frameCount - count + i) % frameHistory];
+    }
+    ImGui::Text("Frame: %.2f ms average, %.2f ms max over %d frames", count ? total / count : 0.0f, longest, count);
+    ImGui::Text("Idle between frames: %.2f ms average", count ? idle / count : 0.0f);
+    ImGui::PlotLines("##frames", times, count, 0, nullptr, 0.0f, std::max(longest, 16.7f), ImVec2(-1, 60));
+
+    // Histogram of frame times in 1 ms buckets up to 50 ms
+    float buckets[50] = {};
+    for (int i = 0; i < count; ++i) {
+        buckets[std::min(49, (int)times[i])] += 1.0f;
+    }
+    ImGui::PlotHistogram("##histogram", buckets, 50, 0, "ms per frame (0-50)", 0.0f, FLT_MAX, ImVec2(-1, 60));
+
+    // Zones of the last full frame, summed by name
+    ImGui::Separator();
+    std::map<std::string_view, double> zones; // The same name may be at several addresses
+    for (const TraceEvent& event : traceSnapshot(lastFrameStart)) {
+        if (event.endNs <= lastFrameEnd) {
+            zones[event.name] += (event.endNs - event.startNs) / 1e6;
+        }
+    }
+    for (const auto& [name, milliseconds] : zones) {
+        ImGui::Text("%-24.*s %7.3f ms", (int)name.size(), name.data(), milliseconds);
+    }
+
+    ImGui::End();
+}
+
+bool exportChromeTrace(const std::string& filename) {
+    std::vector<TraceEvent> events = traceSnapshot(0);
+
+    json trace;
+    trace["displayTimeUnit"] = "ms";
+    json& list = trace["traceEvents"] = json::array();
+    for (const TraceEvent& event : events) {
+        list.push_back({
+            {"name", event.name},
+            {"ph", "X"}, // Complete event
+            {"ts", event.startNs / 1000.0},
+            {"dur", (event.endNs - event.startNs) / 1000.0},
+            {"pid", 1},
+            {"tid", event.thread},
+        });
+    }
+
+    if (!writeFileAtomically(filename, trace.dump())) {
+        std::cerr << "Failed to write " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Trace with " << events.size() << " events saved to " << filename << std::endl;
+    return true;
+}
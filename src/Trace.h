@@ -0,0 +1,46 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Lightweight timing of code regions. Zones are written to a fixed-size lock-free ring
+// buffer, so tracing is always on and old events are overwritten after a while.
+
+// Monotonic time in nanoseconds
+uint64_t traceNow();
+
+// Record a finished zone. name must outlive the trace (normally a string literal).
+void traceZone(const char* name, uint64_t startNs, uint64_t endNs);
+
+// Times the enclosing scope as one zone
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start(traceNow()) {}
+    ~TraceScope() { traceZone(name, start, traceNow()); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+// Mark the start and the end of a drawn frame for the frame-time overlay. Call from the
+// main loop: the start after any wait for events, the end after presenting. Time between
+// frames is counted as idle.
+void traceFrameStart();
+void traceFrame();
+
+// Window with frame times, their histogram and the zones of the last frame
+void renderTraceOverlay(bool* open);
+
+// Write the events in the ring buffer as Chrome trace-event JSON (chrome://tracing, Perfetto)
+bool exportChromeTrace(const std::string& filename);
+
+#endif // TRACE_H
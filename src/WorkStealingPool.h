@@ -0,0 +1,55 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool where every worker has its own task deque. A worker runs its newest task
+// first and, when its deque is empty, steals the oldest task of another worker. Tasks may
+// submit more tasks, which then stay on the submitting worker unless someone steals them.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount 0 uses one worker per hardware thread
+    explicit WorkStealingPool(size_t threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    // Block until every submitted task, including tasks they submitted, has finished
+    void wait();
+
+    size_t threadCount() const { return threads.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool takeTask(size_t index, Task& task);
+    void run(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued{0};     // Tasks sitting in a deque
+    std::atomic<size_t> unfinished{0}; // Tasks submitted and not finished
+    std::atomic<size_t> nextWorker{0}; // Round-robin target for tasks from other threads
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;    // Signalled when a task is queued or the pool stops
+    std::condition_variable finished;  // Signalled when unfinished drops to zero
+    bool stopping = false;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,408 @@
+// Headless entry point: validates, normalizes and converts config files without a window.
+// Nothing here initializes SDL, so it runs in scripts and containers without a display.
+#define SDL_MAIN_HANDLED
+
+#include "CvarManager.h"
+#include "CvarCodec.h"
+#include "ControlsManager.h"
+#include "BindTable.h"
+#include "ConfigDocument.h"
+#include "ConfigValidator.h"
+#include "ExecGraph.h"
+#include "AsyncSaver.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Where command output goes; std::cout carries the loaders' progress messages to stderr
+static std::ostream* output = &std::cout;
+
+static void printUsage() {
+    std::cerr << "Usage: okesl-config-cli [--schema <cvars.json>] <command> ...\n"
+                 "\n"
+                 "Commands:\n"
+                 "  validate <cfg>...            Check config trees (following exec lines)\n"
+                 "  batch <directory>...         Check every autoexec.cfg tree below the directories\n"
+                 "  normalize <cfg> [-o <out>]   Rewrite one file in canonical form\n"
+                 "  convert <in> <out>           Convert between .cfg trees and .json\n"
+                 "  defaults [-o <out>]          Write the editor's default controls.cfg\n"
+                 "\n"
+                 "Paths in exec lines are relative to the working directory, as in the game.\n";
+}
+
+// Write content to filename, or to the output stream when filename is empty
+static bool writeOutput(const std::string& filename, const std::string& content) {
+    if (filename.empty()) {
+        *output << content;
+        return output->good();
+    }
+    if (!writeFileAtomically(filename, content)) {
+        std::cerr << "Failed to write " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Append text padded with spaces to column 20, with at least one space
+static void appendPadded(std::string& out, std::string_view text) {
+    out += text;
+    out.append(text.size() < 20 ? 20 - text.size() : 1, ' ');
+}
+
+// Trim spaces and tabs from both ends
+static std::string_view trimmed(std::string_view text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return std::string_view();
+    }
+    return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+// Canonical form of one file: commands in column 1 with their arguments in column 20,
+// cvar values in their saved format, bind actions without stray whitespace, no trailing
+// whitespace and at most one blank line in a row
+static std::string normalizeConfig(const ConfigDocument& document) {
+    std::string out;
+    std::string actions;
+    bool blank = true; // Drop blank lines at the top
+    for (const ConfigLine& line : document.lines()) {
+        if (line.kind == ConfigLineKind::Blank) {
+            if (!blank) {
+                out += '\n';
+            }
+            blank = true;
+            continue;
+        }
+        blank = false;
+
+        if (line.kind == ConfigLineKind::Comment) {
+            out += trimmed(line.text);
+            out += '\n';
+            continue;
+        }
+
+        auto cvar = cvars.find(line.command);
+        CvarValue value;
+        if (cvar != cvars.end() && parseCvarValue(cvar->second.type, line.key, value)) {
+            Cvar formatted = cvar->second;
+            formatted.value = value;
+            appendPadded(out, line.command);
+            out += formatCvarValue(formatted);
+        } else if (line.command == "bind" && line.quoted && !line.key.empty()) {
+            canonicalSignature(line.actions, actions);
+            appendPadded(out, "bind " + std::string(line.key));
+            out += "\"" + actions + "\"";
+        } else if (!trimmed(line.arguments).empty()) {
+            appendPadded(out, line.command);
+            out += trimmed(line.arguments);
+        } else {
+            out += line.command;
+        }
+        out += '\n';
+    }
+
+    // Drop blank lines at the end
+    while (out.size() >= 2 && out[out.size() - 1] == '\n' && out[out.size() - 2] == '\n') {
+        out.pop_back();
+    }
+    return out;
+}
+
+// JSON value of a cvar. Colors are written as "#RRGGBBAA".
+static json cvarToJson(const Cvar& cvar) {
+    switch (cvar.type) {
+    case CvarType::Bool: return cvar.value.boolValue;
+    case CvarType::Int: return cvar.value.intValue;
+    case CvarType::Float: return cvar.value.floatValue;
+    case CvarType::Color: return "#" + formatCvarValue(cvar);
+    }
+    return nullptr;
+}
+
+// Read a cvar value of a type from JSON. Returns false if the value does not fit the type.
+static bool cvarValueFromJson(CvarType type, const json& value, CvarValue& out) {
+    switch (type) {
+    case CvarType::Bool:
+        if (!value.is_boolean()) return false;
+        out.boolValue = value.get<bool>();
+        return true;
+    case CvarType::Int:
+        if (value.is_number_unsigned()) {
+            if (value.get<uint64_t>() > (uint64_t)INT32_MAX) return false;
+        } else if (!value.is_number_integer() || value.get<int64_t>() < INT32_MIN || value.get<int64_t>() > INT32_MAX) {
+            return false;
+        }
+        out.intValue = (int32_t)value.get<int64_t>();
+        return true;
+    case CvarType::Float:
+        if (!value.is_number() || !(std::fabs(value.get<double>()) <= FLT_MAX)) return false;
+        out.floatValue = value.get<float>();
+        return true;
+    case CvarType::Color: {
+        if (!value.is_string()) return false;
+        std::string_view hex = value.get_ref<const std::string&>();
+        if (!hex.empty() && hex[0] == '#') hex.remove_prefix(1);
+        return parseCvarValue(CvarType::Color, hex, out);
+    }
+    }
+    return false;
+}
+
+// Function to check config trees and print their problems
+static int runValidate(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    size_t problems = 0;
+    for (const std::string& root : args) {
+        ConfigValidator validator;
+        validator.validateTree(root);
+        printDiagnostics(*output, validator.diagnostics());
+        problems += validator.diagnostics().size();
+    }
+    std::cerr << problems << " problem(s) found" << std::endl;
+    return problems == 0 ? 0 : 1;
+}
+
+// Function to check every config tree below some directories in parallel
+static int runBatch(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    size_t treeCount = 0;
+    std::vector<ConfigDiagnostic> diagnostics = validateConfigSets(args, treeCount);
+    printDiagnostics(*output, diagnostics);
+    std::cerr << diagnostics.size() << " problem(s) found in " << treeCount << " config tree(s)" << std::endl;
+    return diagnostics.empty() ? 0 : 1;
+}
+
+// Function to rewrite one config file in canonical form
+static int runNormalize(const std::vector<std::string>& args) {
+    std::string input;
+    std::string outputFile;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "-o" && i + 1 < args.size()) {
+            outputFile = args[++i];
+        } else if (input.empty()) {
+            input = args[i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (input.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    ConfigDocument document;
+    if (!document.load(input)) {
+        std::cerr << "Failed to open " << input << std::endl;
+        return 1;
+    }
+    return writeOutput(outputFile, normalizeConfig(document)) ? 0 : 1;
+}
+
+// Function to write the controls.cfg the editor starts from
+static int runDefaults(const std::vector<std::string>& args) {
+    std::string outputFile;
+    if (args.size() == 2 && args[0] == "-o") {
+        outputFile = args[1];
+    } else if (!args.empty()) {
+        printUsage();
+        return 2;
+    }
+    return writeOutput(outputFile, serializeControls()) ? 0 : 1;
+}
+
+// Function to convert a .cfg tree to JSON
+static int convertCfgToJson(const std::string& input, const std::string& outputFile) {
+    if (!loadConfigTree(input)) {
+        std::cerr << "Failed to open " << input << std::endl;
+        return 1;
+    }
+
+    json j;
+    j["cvars"] = json::object();
+    for (const auto& [name, cvar] : cvars) {
+        Cvar defaults = cvar;
+        defaults.value = cvar.defaultValue;
+        if (formatCvarValue(cvar) != formatCvarValue(defaults)) {
+            j["cvars"][std::string(name)] = cvarToJson(cvar);
+        }
+    }
+    j["binds"] = json::array();
+    bindTable.forEach([&](const BindChord& chord, const std::pmr::string& actions) {
+        j["binds"].push_back({{"key", formatBindChord(chord)}, {"actions", std::string(actions)}});
+    });
+    j["commands"] = configTreeCommands();
+    return writeOutput(outputFile, j.dump(2) + "\n") ? 0 : 1;
+}
+
+// Function to convert JSON written by convertCfgToJson back to a .cfg file
+static int convertJsonToCfg(const std::string& input, const std::string& outputFile) {
+    std::ifstream jsonFile(input);
+    if (!jsonFile.is_open()) {
+        std::cerr << "Failed to open " << input << std::endl;
+        return 1;
+    }
+    json j = json::parse(jsonFile, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        std::cerr << input << ": not a JSON object" << std::endl;
+        return 1;
+    }
+
+    const json cvarValues = j.value("cvars", json::object());
+    const json binds = j.value("binds", json::array());
+    const json commands = j.value("commands", json::array());
+
+    bool ok = true;
+    for (const auto& [name, value] : cvarValues.items()) {
+        auto cvar = cvars.find(name);
+        CvarValue parsed;
+        if (cvar == cvars.end()) {
+            std::cerr << input << ": unknown cvar " << name << std::endl;
+            ok = false;
+        } else if (!cvarValueFromJson(cvar->second.type, value, parsed)) {
+            std::cerr << input << ": invalid " << cvarTypeName(cvar->second.type) << " value for " << name << std::endl;
+            ok = false;
+        } else if (!cvarValueInRange(cvar->second, parsed)) {
+            Cvar bound = cvar->second;
+            bound.value = parsed;
+            std::cerr << input << ": " << name << " = " << formatCvarValue(bound) << " is outside [";
+            bound.value = cvar->second.minValue;
+            std::cerr << formatCvarValue(bound) << ", ";
+            bound.value = cvar->second.maxValue;
+            std::cerr << formatCvarValue(bound) << "]" << std::endl;
+            ok = false;
+        } else {
+            cvar->second.value = parsed;
+        }
+    }
+
+    // Lines that are neither cvars nor binds, e.g. mod and alias lines, go before the
+    // binds that may use them
+    std::string commandLines;
+    if (!commands.is_array()) {
+        std::cerr << input << ": commands must be an array" << std::endl;
+        ok = false;
+    }
+    for (const json& command : commands.is_array() ? commands : json::array()) {
+        if (!command.is_string()) {
+            std::cerr << input << ": commands must be strings" << std::endl;
+            ok = false;
+            continue;
+        }
+        commandLines += command.get_ref<const std::string&>();
+        commandLines += '\n';
+    }
+
+    bindTable.clear();
+    if (!binds.is_array()) {
+        std::cerr << input << ": binds must be an array" << std::endl;
+        ok = false;
+    }
+    for (const json& bind : binds.is_array() ? binds : json::array()) {
+        const json::const_iterator key = bind.is_object() ? bind.find("key") : bind.end();
+        const json::const_iterator actions = bind.is_object() ? bind.find("actions") : bind.end();
+        if (!bind.is_object() || key == bind.end() || !key->is_string() || actions == bind.end() || !actions->is_string()) {
+            std::cerr << input << ": binds must be objects with string key and actions" << std::endl;
+            ok = false;
+            continue;
+        }
+        BindChord chord;
+        if (!parseBindChord(key->get_ref<const std::string&>(), chord)) {
+            std::cerr << input << ": invalid bind key \"" << key->get_ref<const std::string&>() << "\"" << std::endl;
+            ok = false;
+            continue;
+        }
+        bindTable.bind(chord, actions->get_ref<const std::string&>());
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::string content = serializeCvars() + "\n";
+    if (!commandLines.empty()) {
+        content += commandLines + "\n";
+    }
+    content += serializeBinds();
+    return writeOutput(outputFile, content) ? 0 : 1;
+}
+
+// Function to convert between formats, chosen by the file extensions
+static int runConvert(const std::vector<std::string>& args) {
+    if (args.size() != 2) {
+        printUsage();
+        return 2;
+    }
+
+    const std::string inputExtension = fs::path(args[0]).extension().string();
+    const std::string outputExtension = fs::path(args[1]).extension().string();
+    const std::string outputFile = args[1] == "-" ? std::string() : args[1];
+    if (inputExtension == ".cfg" && (outputExtension == ".json" || args[1] == "-")) {
+        return convertCfgToJson(args[0], outputFile);
+    }
+    if (inputExtension == ".json" && (outputExtension == ".cfg" || args[1] == "-")) {
+        return convertJsonToCfg(args[0], outputFile);
+    }
+    std::cerr << "Cannot convert " << args[0] << " to " << args[1] << " (expected .cfg and .json)" << std::endl;
+    return 2;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    std::string schemaFile = "assets/cvars.json";
+    if (args.size() >= 2 && args[0] == "--schema") {
+        schemaFile = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    // Keep stdout for results; the loaders report progress on std::cout
+    std::ostream results(std::cout.rdbuf());
+    output = &results;
+    std::cout.rdbuf(std::clog.rdbuf());
+
+    loadCvarSchema(schemaFile);
+
+    const std::string command = args[0];
+    args.erase(args.begin());
+
+    int status = 2;
+    if (command == "validate") {
+        status = runValidate(args);
+    } else if (command == "batch") {
+        status = runBatch(args);
+    } else if (command == "normalize") {
+        status = runNormalize(args);
+    } else if (command == "convert") {
+        status = runConvert(args);
+    } else if (command == "defaults") {
+        status = runDefaults(args);
+    } else {
+        printUsage();
+    }
+
+    results.flush();
+    std::cout.rdbuf(results.rdbuf());
+    return status;
+}
@@ -3,6 +3,12 @@
 #include "imgui_impl_sdlrenderer2.h"
 #include "CvarManager.h"
 #include "ControlsManager.h"
+#include "FrameScheduler.h"
+#include "AsyncSaver.h"
+#include "ExecGraph.h"
+#include "FileWatcher.h"
+#include "EditHistory.h"
+#include "Trace.h"
 #include <SDL.h>
 #include <iostream>
 
@@ -10,14 +16,41 @@
 #error This backend requires SDL 2.0.17+ because of SDL_RenderGeometry() function
 #endif
 
+// Block while idle instead of redrawing every frame
+static bool powerSaving = true;
+
+// How long an idle main loop sleeps before checking its state again
+static const int idleTimeoutMs = 250;
+
+// Dear ImGui shows the text cursor for 0.8 s and hides it for 0.4 s, so a focused text
+// field needs a frame this often for the blink to show
+static const Uint32 caretBlinkMs = 400;
+
+// Show the frame-time overlay
+static bool showTraceOverlay = false;
+
 void renderMenuBar() {
+    // Global shortcuts; a focused text field still gets its own Ctrl+Z first
+    if (!isCapturingKey()) {
+        if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_Z, ImGuiInputFlags_RouteGlobal)) {
+            undoEdit();
+        }
+        if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_Y, ImGuiInputFlags_RouteGlobal) ||
+            ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_Z, ImGuiInputFlags_RouteGlobal)) {
+            redoEdit();
+        }
+    }
+
     if (ImGui::BeginMainMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("Save cvars")) {
-                saveCvarsToFile("cfg/cvars.cfg");
+                queueCvarsSave("cfg/cvars.cfg");
             }
             if (ImGui::MenuItem("Save controls")) {
-                saveControls("cfg/controls.cfg");
+                queueControlsSave("cfg/controls.cfg");
+            }
+            if (ImGui::MenuItem("Export trace")) {
+                exportChromeTrace("okesl-trace.json");
             }
             if (ImGui::MenuItem("Exit")) {
                 SDL_Event quitEvent;
@@ -26,6 +59,20 @@ void renderMenuBar() {
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Edit")) {
+            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, canUndo())) {
+                undoEdit();
+            }
+            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, canRedo())) {
+                redoEdit();
+            }
+            ImGui::EndMenu();
+        }
+        if (ImGui::BeginMenu("View")) {
+            ImGui::MenuItem("Power saving", nullptr, &powerSaving);
+            ImGui::MenuItem("Frame time overlay", nullptr, &showTraceOverlay);
+            ImGui::EndMenu();
+        }
         ImGui::EndMainMenuBar();
     }
 }
@@ -37,6 +84,7 @@ int main(int, char**)
         printf("Error: %s\n", SDL_GetError());
         return -1;
     }
+    initFrameScheduler();
 
     // From 2.0.18: Enable native IME.
 #ifdef SDL_HINT_IME_SHOW_UI
@@ -71,18 +119,44 @@ int main(int, char**)
     ImGui_ImplSDLRenderer2_Init(renderer);
 
     // Load cvars
-    if (!loadCvars("assets/cvars.json", "cfg/cvars.cfg")) {
+    if (!loadCvarSchema("assets/cvars.json")) {
         return -1;
     }
 
-    // Load controls
-    loadControls("cfg/controls.cfg");
+    // Load the config tree like the game does, or the editor's own files without autoexec.cfg
+    const std::string rootFilename = "cfg/autoexec.cfg";
+    bool treeLoaded = loadConfigTree(rootFilename);
+    if (!treeLoaded)
+        loadConfigFiles({"cfg/cvars.cfg", "cfg/controls.cfg"});
+
+    // Pick up changes the game or a text editor makes to the loaded files, files that are
+    // created later, and autoexec.cfg appearing
+    std::vector<std::string> watchList = configWatchList();
+    watchList.push_back(rootFilename);
+    watchFiles(watchList);
 
     // Our state
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     // Main loop
     bool done = false;
+    Uint32 lastFrameTicks = 0;
+    auto handleEvent = [&](const SDL_Event& event) {
+        TRACE_ZONE("handleEvent");
+        ImGui_ImplSDL2_ProcessEvent(&event);
+        if (event.type == SDL_QUIT)
+            done = true;
+        if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
+            done = true;
+
+        // Pass events to KeybindingManager
+        processKeybindingEvents(event);
+
+        // Dear ImGui needs a few frames to settle hover and layout after input
+        if (!isRedrawEvent(event.type))
+            requestRedraw(3);
+    };
+
     while (!done)
     {
         // Poll and handle events (inputs, window resize, etc.)
@@ -90,23 +164,60 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+        //
+        // In power saving mode, sleep until input arrives unless something asked for a redraw
+        // or a key capture is pending in the controls editor. A focused text field wakes
+        // the loop when its cursor blinks.
         SDL_Event event;
+        bool woken = false;
+        bool blinking = io.WantTextInput && io.ConfigInputTextCursorBlink;
+        bool blinkDue = blinking && SDL_GetTicks() - lastFrameTicks >= caretBlinkMs;
+        if (powerSaving && !redrawPending() && !isCapturingKey() && !blinkDue)
+        {
+            TRACE_ZONE("idle");
+            int timeoutMs = idleTimeoutMs;
+            if (blinking)
+                timeoutMs = SDL_min(timeoutMs, (int)(caretBlinkMs - (SDL_GetTicks() - lastFrameTicks)));
+            woken = SDL_WaitEventTimeout(&event, timeoutMs);
+            blinkDue = blinking && SDL_GetTicks() - lastFrameTicks >= caretBlinkMs;
+        }
+        traceFrameStart();
+        if (woken)
+            handleEvent(event);
         while (SDL_PollEvent(&event))
+            handleEvent(event);
+
+        // Finish saves the background writer completed, then merge files changed on disk;
+        // both have already requested a redraw
+        runSaveCallbacks();
+        bool reloaded = false;
+        for (const std::string& path : takeChangedFiles())
         {
-            ImGui_ImplSDL2_ProcessEvent(&event);
-            if (event.type == SDL_QUIT)
-                done = true;
-            if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
-                done = true;
-
-            // Pass events to KeybindingManager
-            processKeybindingEvents(event);
+            if (!treeLoaded && path == rootFilename)
+            {
+                treeLoaded = loadConfigTree(rootFilename);
+                reloaded |= treeLoaded;
+            }
+            else
+                reloaded |= reloadConfigFile(path);
         }
+        if (reloaded)
+        {
+            // The loaded files may have changed
+            watchList = configWatchList();
+            watchList.push_back(rootFilename);
+            watchFiles(watchList);
+        }
+
+        if (done)
+            break;
         if (SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED)
         {
             SDL_Delay(10);
             continue;
         }
+        if (powerSaving && !redrawPending() && !isCapturingKey() && !blinkDue)
+            continue;
 
         // Start the Dear ImGui frame
         ImGui_ImplSDLRenderer2_NewFrame();
@@ -114,27 +225,54 @@ int main(int, char**)
         ImGui::NewFrame();
 
         // Render menu bar
-        renderMenuBar();
+        {
+            TRACE_ZONE("renderMenuBar");
+            renderMenuBar();
+        }
 
         // Render cvars GUI
-        ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver); // Set default window size
-        ImGui::Begin("Cvars Editor");
-        renderCvars();
-        ImGui::End();
+        {
+            TRACE_ZONE("renderCvars");
+            ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver); // Set default window size
+            ImGui::Begin("Cvars Editor");
+            renderCvars();
+            ImGui::End();
+        }
 
         // Render the keybinding editor
-        renderControlsEditor();
+        {
+            TRACE_ZONE("renderControlsEditor");
+            renderControlsEditor();
+        }
+
+        if (showTraceOverlay)
+            renderTraceOverlay(&showTraceOverlay);
 
         // Rendering
-        ImGui::Render();
-        SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
-        SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255), (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
-        SDL_RenderClear(renderer);
-        ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer);
-        SDL_RenderPresent(renderer);
+        {
+            TRACE_ZONE("ImGui::Render");
+            ImGui::Render();
+        }
+        {
+            TRACE_ZONE("RenderDrawData");
+            SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
+            SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255), (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
+            SDL_RenderClear(renderer);
+            ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer);
+        }
+        {
+            TRACE_ZONE("SDL_RenderPresent");
+            SDL_RenderPresent(renderer);
+        }
+
+        frameDrawn();
+        lastFrameTicks = SDL_GetTicks();
+        traceFrame();
     }
 
     // Cleanup
+    stopFileWatcher();
+    shutdownSaver(); // Finish queued saves before exiting
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+"""Check that the shipped configs and the default controls bind no chord twice.
+
+Usage: check_shipped_configs.py <okesl-config-cli> <resources directory>
+
+The sample files of resources/cfg are copied into a scratch game directory
+together with the controls.cfg the editor writes by default and an empty
+cvars.cfg, then the tree is validated from autoexec.cfg. A chord bound to
+different actions in two places, which the controls editor would flag as a
+conflict, fails the check. Other diagnostics are left to "validate".
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+def main():
+    cli = sys.argv[1]
+    resources = sys.argv[2]
+    schema = os.path.join(resources, 'assets', 'cvars.json')
+
+    with tempfile.TemporaryDirectory() as game:
+        cfg = os.path.join(game, 'cfg')
+        shutil.copytree(os.path.join(resources, 'cfg'), cfg)
+        subprocess.run([cli, '--schema', schema, 'defaults', '-o', os.path.join(cfg, 'controls.cfg')], check=True)
+        cvars = os.path.join(cfg, 'cvars.cfg')
+        if not os.path.exists(cvars):
+            open(cvars, 'w').close()
+
+        result = subprocess.run([cli, '--schema', schema, 'batch', game], stdout=subprocess.PIPE, text=True)
+        conflicts = [line for line in result.stdout.splitlines() if ' replaces "' in line]
+        for line in conflicts:
+            print(line)
+        print(f'{len(conflicts)} conflicting bind(s) found')
+        return 1 if conflicts else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
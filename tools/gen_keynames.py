@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Generate the minimal perfect hash from key names to scancodes.
+
+Usage: gen_keynames.py <keystr.h> <output header>
+
+The names are read from the keystr table in keystr.h. The search for the
+hash runs here rather than in a constexpr function, which would exceed the
+constant evaluation limits of the compilers. KeyNames.h checks the result
+with static_asserts.
+"""
+
+import re
+import sys
+
+MASK = 0xFFFFFFFF
+
+
+def hash_key_name(seed, name):
+    # FNV-1a, varied by seed; must match hashKeyName in KeyNames.h
+    value = 2166136261 ^ ((seed * 16777619) & MASK)
+    for c in name.encode('utf-8'):
+        value = ((value ^ c) * 16777619) & MASK
+    return value
+
+
+def read_keystr(path):
+    with open(path, encoding='utf-8') as f:
+        text = f.read()
+    count = int(re.search(r'#define\s+KEYSTR_MAX\s+(\d+)', text).group(1))
+    table = text[text.index('keystr['):]
+    table = table[table.index('{'):table.index('};')]
+    names = re.findall(r'"((?:[^"\\]|\\.)*)"', table)
+    if len(names) != count:
+        sys.exit('{}: expected {} names, found {}'.format(path, count, len(names)))
+    return names
+
+
+# Hash and displace: place the buckets from largest to smallest, searching for each
+# bucket a seed that sends all of its keys to distinct free slots.
+def build_table(names):
+    keys = [i for i, name in enumerate(names) if name]
+    key_count = len(keys)
+    buckets = [[] for _ in range(key_count)]
+    for i in keys:
+        buckets[hash_key_name(0, names[i]) % key_count].append(i)
+
+    seeds = [0] * key_count
+    scancodes = [0] * key_count
+    used = [False] * key_count
+    order = sorted(range(key_count), key=lambda bucket: (-len(buckets[bucket]), bucket))
+    for bucket in order:
+        if not buckets[bucket]:
+            break
+        for seed in range(1, 65536):
+            slots = [hash_key_name(seed, names[i]) % key_count for i in buckets[bucket]]
+            if len(set(slots)) == len(slots) and not any(used[slot] for slot in slots):
+                break
+        else:
+            sys.exit('no minimal perfect hash found for keystr')
+        for slot, i in zip(slots, buckets[bucket]):
+            used[slot] = True
+            scancodes[slot] = i
+        seeds[bucket] = seed
+    return seeds, scancodes
+
+
+def cpp_array(values, per_line=16):
+    rows = []
+    for start in range(0, len(values), per_line):
+        rows.append('    ' + ', '.join(str(v) for v in values[start:start + per_line]) + ',')
+    return rows
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    seeds, scancodes = build_table(read_keystr(sys.argv[1]))
+    lines = [
+        '// Generated by tools/gen_keynames.py. Do not edit.',
+        '#ifndef KEYNAMES_GEN_H',
+        '#define KEYNAMES_GEN_H',
+        '',
+        'namespace keynames_detail {',
+        '',
+        'constexpr size_t keyCount = {};'.format(len(scancodes)),
+        'constexpr size_t bucketCount = keyCount;',
+        '',
+        '// Per-bucket seed of the second hash',
+        'constexpr uint16_t keyHashSeeds[bucketCount] = {',
+    ]
+    lines += cpp_array(seeds)
+    lines += [
+        '};',
+        '',
+        '// Scancode stored in each slot',
+        'constexpr uint8_t keyHashScancodes[keyCount] = {',
+    ]
+    lines += cpp_array(scancodes)
+    lines += [
+        '};',
+        '',
+        '} // namespace keynames_detail',
+        '',
+        '#endif // KEYNAMES_GEN_H',
+        '',
+    ]
+
+    with open(sys.argv[2], 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
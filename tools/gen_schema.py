@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Generate the compiled-in cvar and command schema from the JSON assets.
+
+Usage: gen_schema.py <cvars.json> <ccmds.json> <output header>
+
+Values are emitted as typed brace initializers, so a default, min or max
+that does not fit the declared type fails to compile instead of failing
+at first run.
+"""
+
+import json
+import sys
+
+
+def cpp_string(value):
+    return json.dumps(value)
+
+
+def cpp_value(cvar_type, value):
+    if cvar_type == 'color':
+        return 'CvarValue(parseSchemaColor({}))'.format(cpp_string(value))
+    if cvar_type == 'float':
+        # Brace-initialize from a double literal so non-numbers are rejected
+        return 'CvarValue(float{{{}}})'.format(json.dumps(value))
+    cpp_type = {'bool': 'bool', 'int': 'int32_t'}.get(cvar_type, cvar_type)
+    return 'CvarValue({}{{{}}})'.format(cpp_type, json.dumps(value))
+
+
+def cpp_type_tag(cvar_type):
+    # Unknown types produce an unknown enumerator and fail to compile
+    return 'CvarType::' + cvar_type[:1].upper() + cvar_type[1:]
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+
+    with open(sys.argv[1], encoding='utf-8') as f:
+        cvars = json.load(f)
+    with open(sys.argv[2], encoding='utf-8') as f:
+        commands = json.load(f)
+
+    lines = [
+        '// Generated by tools/gen_schema.py. Do not edit.',
+        '#ifndef CVARSCHEMA_GEN_H',
+        '#define CVARSCHEMA_GEN_H',
+        '',
+        'static constexpr CvarSchemaEntry generatedCvarSchema[] = {',
+    ]
+    for name, entry in cvars.items():
+        cvar_type = entry['type']
+        fields = [cpp_string(name), cpp_type_tag(cvar_type), cpp_value(cvar_type, entry['default'])]
+        if 'min' in entry and cvar_type in ('int', 'float'):
+            fields.append(cpp_value(cvar_type, entry['min']))
+            fields.append(cpp_value(cvar_type, entry['max']))
+        else:
+            fields += ['CvarValue()', 'CvarValue()']
+        lines.append('    {' + ', '.join(fields) + '},')
+    lines += [
+        '};',
+        '',
+        'static constexpr CommandSchemaEntry generatedCommandSchema[] = {',
+    ]
+    for command in commands:
+        lines.append('    {{{}, {}}},'.format(cpp_string(command['name']), cpp_string(command.get('description', ''))))
+    lines += [
+        '};',
+        '',
+        'static_assert(validateCvarSchema(generatedCvarSchema), "cvars.json: default outside [min, max] or duplicate name");',
+        '',
+        '#endif // CVARSCHEMA_GEN_H',
+        '',
+    ]
+
+    with open(sys.argv[3], 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()